@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace MagicSquares {
+
+	// The cells of a square start on a cache line boundary
+	const size_t CACHE_LINE_SIZE = 64;
+
+	// std::allocator only guarantees the alignment of max_align_t : over allocate and keep the block address before the cells
+	template <typename T>
+	class CacheAlignedAllocator
+	{
+	public:
+
+		typedef T value_type;
+
+		CacheAlignedAllocator() {};
+
+		template <typename U>
+		CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {};
+
+		T* allocate(size_t n) {
+			char* block = static_cast<char*>(::operator new(n * sizeof(T) + sizeof(void*) + CACHE_LINE_SIZE - 1));
+			const uintptr_t cells = (reinterpret_cast<uintptr_t>(block) + sizeof(void*) + CACHE_LINE_SIZE - 1) & ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1);
+			reinterpret_cast<void**>(cells)[-1] = block;
+			return reinterpret_cast<T*>(cells);
+		};
+
+		void deallocate(T* cells, size_t) {
+			::operator delete(reinterpret_cast<void**>(cells)[-1]);
+		};
+
+		template <typename U>
+		bool operator==(const CacheAlignedAllocator<U>&) const {
+			return true;
+		};
+
+		template <typename U>
+		bool operator!=(const CacheAlignedAllocator<U>&) const {
+			return false;
+		};
+
+	};
+
+	// Square of N x N cells (N = root * root), stored row after row (i * N + j) in one contiguous cache aligned block.
+	// square[i][j] keeps the syntax of the old vector of vectors, square[i] being a pointer on the first cell of i.
+	// Root only known at run time (Root = 0) : see below for a square with a compile time root.
+	template <typename CellT, size_t Root = 0>
+	class BasicSquare;
+
+	template <typename CellT>
+	class BasicSquare<CellT, 0>
+	{
+	public:
+
+		typedef CellT cell_type;
+
+		explicit BasicSquare(size_t root_size, CellT value = CellT()) :
+				mRootSize(root_size),
+				mSideSize(root_size * root_size),
+				mCells(mSideSize * mSideSize, value) {
+		};
+
+		size_t rootSize() const {
+			return mRootSize;
+		};
+
+		size_t sideSize() const {
+			return mSideSize;
+		};
+
+		size_t cellsNumber() const {
+			return mCells.size();
+		};
+
+		CellT* operator[](size_t i) {
+			return mCells.data() + i * mSideSize;
+		};
+
+		const CellT* operator[](size_t i) const {
+			return mCells.data() + i * mSideSize;
+		};
+
+		CellT* data() {
+			return mCells.data();
+		};
+
+		const CellT* data() const {
+			return mCells.data();
+		};
+
+		void fill(CellT value) {
+			std::fill(mCells.begin(), mCells.end(), value);
+		};
+
+		size_t count(CellT value) const {
+			return static_cast<size_t>(std::count(mCells.begin(), mCells.end(), value));
+		};
+
+		bool operator==(const BasicSquare& other) const {
+			return (mSideSize == other.mSideSize) && (mCells == other.mCells);
+		};
+
+		bool operator!=(const BasicSquare& other) const {
+			return !(*this == other);
+		};
+
+	private:
+
+		size_t mRootSize;
+		size_t mSideSize;
+		std::vector<CellT, CacheAlignedAllocator<CellT> > mCells;
+
+	};
+
+	// Same interface, with a fast path for the root size Root : its cells are a member array (no allocation,
+	// copies of a few cache lines) and the loops have constant bounds. The other root sizes use a heap block.
+	template <typename CellT, size_t Root>
+	class BasicSquare
+	{
+	public:
+
+		typedef CellT cell_type;
+
+		static const size_t FIXED_ROOT_SIZE = Root;
+		static const size_t FIXED_SIDE_SIZE = Root * Root;
+		static const size_t FIXED_CELLS_NUMBER = FIXED_SIDE_SIZE * FIXED_SIDE_SIZE;
+
+		explicit BasicSquare(size_t root_size, CellT value = CellT()) :
+				mRootSize(root_size),
+				mSideSize(root_size * root_size),
+				mFixedCells(),
+				mHeapCells((root_size == Root) ? 0 : mSideSize * mSideSize, value),
+				mCells((root_size == Root) ? mFixedCells : mHeapCells.data()) {
+			this->fill(value);
+		};
+
+		BasicSquare(const BasicSquare& other) :
+				mRootSize(other.mRootSize),
+				mSideSize(other.mSideSize),
+				mHeapCells(other.mHeapCells) {
+			this->copyFixedCells(other);
+			mCells = this->isFixed() ? mFixedCells : mHeapCells.data();
+		};
+
+		BasicSquare& operator=(const BasicSquare& other) {
+			mRootSize = other.mRootSize;
+			mSideSize = other.mSideSize;
+			mHeapCells = other.mHeapCells;
+			this->copyFixedCells(other);
+			mCells = this->isFixed() ? mFixedCells : mHeapCells.data();
+			return *this;
+		};
+
+		BasicSquare(BasicSquare&& other) :
+				mRootSize(other.mRootSize),
+				mSideSize(other.mSideSize),
+				mHeapCells(std::move(other.mHeapCells)) {
+			this->copyFixedCells(other);
+			mCells = this->isFixed() ? mFixedCells : mHeapCells.data();
+		};
+
+		BasicSquare& operator=(BasicSquare&& other) {
+			mRootSize = other.mRootSize;
+			mSideSize = other.mSideSize;
+			mHeapCells = std::move(other.mHeapCells);
+			this->copyFixedCells(other);
+			mCells = this->isFixed() ? mFixedCells : mHeapCells.data();
+			return *this;
+		};
+
+		size_t rootSize() const {
+			return mRootSize;
+		};
+
+		size_t sideSize() const {
+			return mSideSize;
+		};
+
+		size_t cellsNumber() const {
+			return this->isFixed() ? FIXED_CELLS_NUMBER : mHeapCells.size();
+		};
+
+		CellT* operator[](size_t i) {
+			return mCells + i * mSideSize;
+		};
+
+		const CellT* operator[](size_t i) const {
+			return mCells + i * mSideSize;
+		};
+
+		CellT* data() {
+			return mCells;
+		};
+
+		const CellT* data() const {
+			return mCells;
+		};
+
+		void fill(CellT value) {
+			if (this->isFixed()) {
+				for (size_t k = 0; k < FIXED_CELLS_NUMBER; k++) {
+					mFixedCells[k] = value;
+				}
+			} else {
+				std::fill(mHeapCells.begin(), mHeapCells.end(), value);
+			}
+		};
+
+		size_t count(CellT value) const {
+			if (this->isFixed()) {
+				size_t n = 0;
+				for (size_t k = 0; k < FIXED_CELLS_NUMBER; k++) {
+					n += (mFixedCells[k] == value) ? 1 : 0;
+				}
+				return n;
+			}
+			return static_cast<size_t>(std::count(mHeapCells.begin(), mHeapCells.end(), value));
+		};
+
+		bool operator==(const BasicSquare& other) const {
+			if (mSideSize != other.mSideSize) {
+				return false;
+			}
+			if (this->isFixed()) {
+				for (size_t k = 0; k < FIXED_CELLS_NUMBER; k++) {
+					if (mFixedCells[k] != other.mFixedCells[k]) {
+						return false;
+					}
+				}
+				return true;
+			}
+			return mHeapCells == other.mHeapCells;
+		};
+
+		bool operator!=(const BasicSquare& other) const {
+			return !(*this == other);
+		};
+
+	private:
+
+		bool isFixed() const {
+			return mRootSize == Root;
+		};
+
+		void copyFixedCells(const BasicSquare& other) {
+			if (other.isFixed()) {
+				for (size_t k = 0; k < FIXED_CELLS_NUMBER; k++) {
+					mFixedCells[k] = other.mFixedCells[k];
+				}
+			}
+		};
+
+		size_t mRootSize;
+		size_t mSideSize;
+		CellT  mFixedCells[FIXED_CELLS_NUMBER];                    // root size Root only
+		std::vector<CellT, CacheAlignedAllocator<CellT> > mHeapCells;    // any other root size
+		CellT* mCells;
+
+	};
+
+	// A cell holds a value up to 225 (root 15) in a byte
+	typedef uint8_t GridCell;
+
+	const size_t MAX_GRID_CELL_ROOT_SIZE = 15;
+
+	// The usual 9 x 9 grid, with the fixed size cells of BasicSquare
+	const size_t STANDARD_GRID_ROOT_SIZE = 3;
+
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BatchSolver.h"
+#include "MagicSquare.h"
+
+namespace MagicSquares {
+
+	BatchSolver::BatchSolver(size_t threads_number, size_t window_size) :
+			mThreadsNumber(threads_number),
+			mWindowSize(window_size),
+			mCheckUniqueness(false) {
+
+		if (mThreadsNumber == 0) {
+			mThreadsNumber = std::thread::hardware_concurrency();
+		}
+		if (mThreadsNumber == 0) {
+			mThreadsNumber = 1;
+		}
+		if (mWindowSize == 0) {
+			mWindowSize = 1;
+		}
+		for (size_t s = 0; s <= PUZZLE_INVALID; s++) {
+			mStatusNumbers[s] = 0;
+		}
+	}
+
+	BatchSolver::~BatchSolver() {
+		// Something to do ?
+	}
+
+	size_t BatchSolver::solve(PuzzleReader& reader, const ResultSink& sink) {
+
+		// The puzzle n stays in the slot n % window size from its reading until its result is sent.
+		// The slots are reused : their strings keep their capacity from one puzzle to the next
+		std::vector<PuzzleResult> window(mWindowSize);
+		std::vector<bool>         solved(mWindowSize, false);
+
+		std::mutex              mutex;
+		std::condition_variable puzzle_read;    // workers : a puzzle to take, or the input over
+		std::condition_variable results_ready;  // reading thread : the results it waits for are ready
+		size_t read_number = 0;                 // puzzles put in the window
+		size_t taken_number = 0;                // puzzles taken by the workers, in the input order
+		size_t sent_number = 0;                 // results sent to the sink
+		size_t awaited_number = 0;              // results the reading thread waits for (sent ones included)
+		bool   input_over = false;
+
+		for (size_t s = 0; s <= PUZZLE_INVALID; s++) {
+			mStatusNumbers[s] = 0;
+		}
+
+		auto worker = [&]() {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true) {
+				puzzle_read.wait(lock, [&]() {
+					return (taken_number < read_number) || input_over;
+				});
+				if (taken_number == read_number) {
+					return;
+				}
+				const size_t n = taken_number++;
+
+				lock.unlock();
+				this->solvePuzzle(window[n % mWindowSize]);
+				lock.lock();
+
+				solved[n % mWindowSize] = true;
+				if ((n == sent_number) || (n + 1 == awaited_number)) {
+					results_ready.notify_one();
+				}
+			}
+		};
+
+		// Results of the solved puzzles at the front of the window, in the input order. The reading thread can wait
+		// for the next wait_number ones first : by batches, not to be woken up for each puzzle. The sink is called
+		// out of the lock, the workers go on meanwhile
+		auto sendSolved = [&](size_t wait_number) {
+			std::unique_lock<std::mutex> lock(mutex);
+			if (wait_number > 0) {
+				awaited_number = sent_number + wait_number;
+				results_ready.wait(lock, [&]() {
+					return solved[sent_number % mWindowSize] && solved[(awaited_number - 1) % mWindowSize];
+				});
+			}
+			while ((sent_number < read_number) && solved[sent_number % mWindowSize]) {
+				PuzzleResult& result = window[sent_number % mWindowSize];
+				lock.unlock();
+
+				mStatusNumbers[result.Status]++;
+				sink(sent_number, result.Status, result.Puzzle, result.Solution);
+
+				lock.lock();
+				solved[sent_number % mWindowSize] = false;
+				sent_number++;
+			}
+		};
+
+		const size_t send_batch = (mWindowSize + 3) / 4;
+
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < mThreadsNumber; t++) {
+			workers.emplace_back(worker);
+		}
+
+		const char* puzzle = nullptr;
+		size_t      length = 0;
+
+		while (reader.nextPuzzle(puzzle, length)) {
+			// Window full : its oldest puzzles must be sent to free their slots
+			if (read_number - sent_number == mWindowSize) {
+				sendSolved(send_batch);
+			}
+
+			window[read_number % mWindowSize].Puzzle.assign(puzzle, length);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				read_number++;
+			}
+			puzzle_read.notify_one();
+
+			sendSolved(0);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			input_over = true;
+		}
+		puzzle_read.notify_all();
+
+		while (sent_number < read_number) {
+			sendSolved(std::min(send_batch, read_number - sent_number));
+		}
+		for (auto& thread : workers) {
+			thread.join();
+		}
+
+		return read_number;
+	}
+
+	void BatchSolver::solvePuzzle(PuzzleResult& result) const {
+		result.Solution.clear();
+		result.Status = PUZZLE_INVALID;
+
+		const size_t root_size = RegulareSquare::rootSizeOfLine(result.Puzzle.size());
+		if (root_size == 0) {
+			return;
+		}
+
+		RegulareSquare grid(root_size);
+		grid.setVerbose(false);
+
+		// Clues without conflict leaving a cell without any value (lookahead of setValue) : a puzzle, without solution
+		const RegulareSquare::ERROR_CODE ret = grid.fromLine(result.Puzzle.data(), result.Puzzle.size());
+		if (ret == RegulareSquare::ERR_UNABLE_TO_FILL_HINTS) {
+			result.Status = PUZZLE_NO_SOLUTION;
+			return;
+		}
+		if (ret != RegulareSquare::ERR_OK) {
+			return;
+		}
+
+		if (grid.isGridCompleted()) {
+			result.Status = PUZZLE_SOLVED;
+			result.Solution = grid.toLine();
+			return;
+		}
+
+		// A single search : up to the second solution when the uniqueness is checked, the first one is kept
+		const size_t cells_number = root_size * root_size * root_size * root_size;
+		std::vector<GridCell> first_solution;
+		const size_t solutions_number = grid.enumerateSolutions([&first_solution, cells_number](const GridCell* values) {
+			if (first_solution.empty()) {
+				first_solution.assign(values, values + cells_number);
+			}
+			return true;
+		}, mCheckUniqueness ? 2 : 1);
+
+		if (solutions_number == 0) {
+			result.Status = PUZZLE_NO_SOLUTION;
+		} else {
+			grid.fromValues(first_solution.data());
+			result.Solution = grid.toLine();
+			result.Status = (solutions_number > 1) ? PUZZLE_MULTIPLE_SOLUTIONS : PUZZLE_SOLVED;
+		}
+	}
+
+	const char* BatchSolver::statusName(PUZZLE_STATUS status) {
+		switch (status) {
+		case PUZZLE_SOLVED:
+			return "solved";
+		case PUZZLE_MULTIPLE_SOLUTIONS:
+			return "multiple";
+		case PUZZLE_NO_SOLUTION:
+			return "unsolvable";
+		default:
+			return "invalid";
+		}
+	}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "PuzzleReader.h"
+
+namespace MagicSquares {
+
+	// Solves a stream of puzzles on a pool of worker threads, started once for the whole stream.
+	// The calling thread reads the puzzles into a reorder window of window_size slots, the workers take them in
+	// the input order, and the results are sent in the input order as soon as the oldest puzzle is solved.
+	// The memory stays bounded whatever the input size : the reading waits while the window is full.
+	class BatchSolver
+	{
+	public:
+
+		enum PUZZLE_STATUS {
+			PUZZLE_SOLVED = 0,
+			PUZZLE_MULTIPLE_SOLUTIONS,   // only when the uniqueness is checked
+			PUZZLE_NO_SOLUTION,          // clues leaving a cell without any value included
+			PUZZLE_INVALID               // bad length, character, or a value repeated in a row, column or block
+		};
+
+		// Receives each result in input order, one call at a time.
+		// solution is the first solution found (empty without solution)
+		typedef std::function<void(size_t puzzle_index, PUZZLE_STATUS status, const std::string& puzzle, const std::string& solution)> ResultSink;
+
+		// threads_number 0 : one worker per hardware thread
+		explicit BatchSolver(size_t threads_number = 0, size_t window_size = 4096);
+
+		virtual ~BatchSolver();
+
+		// Look for a second solution (slower)
+		void setCheckUniqueness(bool check_uniqueness) {
+			mCheckUniqueness = check_uniqueness;
+		};
+
+		size_t getThreadsNumber() const {
+			return mThreadsNumber;
+		};
+
+		// Solve all the puzzles of the reader, returns the number of puzzles read
+		size_t solve(PuzzleReader& reader, const ResultSink& sink);
+
+		size_t getStatusNumber(PUZZLE_STATUS status) const {
+			return mStatusNumbers[status];
+		};
+
+		static const char* statusName(PUZZLE_STATUS status);
+
+	private:
+
+		typedef struct {
+			std::string   Puzzle;
+			std::string   Solution;
+			PUZZLE_STATUS Status;
+		} PuzzleResult;
+
+		size_t mThreadsNumber;
+		size_t mWindowSize;   // puzzles read and not yet sent
+		bool   mCheckUniqueness;
+		size_t mStatusNumbers[PUZZLE_INVALID + 1];
+
+		void solvePuzzle(PuzzleResult& result) const;
+
+	};
+
+}
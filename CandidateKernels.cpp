@@ -0,0 +1,355 @@
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CANDIDATE_KERNELS_X86 1
+#define CANDIDATE_KERNELS_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CANDIDATE_KERNELS_X86 1
+#define CANDIDATE_KERNELS_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#include "CandidateKernels.h"
+
+namespace MagicSquares {
+
+	namespace {
+
+		inline void accumulate(ValueMask& once, ValueMask& twice, ValueMask values) {
+			twice |= once & values;
+			once |= values;
+		}
+
+		inline void combine(ValueMask& once, ValueMask& twice, ValueMask other_once, ValueMask other_twice) {
+			twice |= other_twice | (once & other_once);
+			once |= other_once;
+		}
+
+		inline bool isSingleCell(const ValueMask* candidates, const GridCell* cells, size_t k) {
+			return (cells[k] == 0) && (clearLowestValue(candidates[k]) == 0);
+		}
+
+		// The band bi (lines bi * R to bi * R + R - 1) is accumulated per j : add it to the j units, and
+		// fold its R * R cells groups into the blocks of the band
+		void foldBand(const ValueMask* band_once, const ValueMask* band_twice, size_t root_size, size_t bi,
+					  ValueMask* seen_once, ValueMask* seen_twice) {
+			const size_t N = root_size * root_size;
+
+			for (size_t j = 0; j < N; j++) {
+				combine(seen_once[j], seen_twice[j], band_once[j], band_twice[j]);
+			}
+
+			for (size_t bj = 0; bj < root_size; bj++) {
+				ValueMask once = 0;
+				ValueMask twice = 0;
+				for (size_t k = bj * root_size; k < (bj + 1) * root_size; k++) {
+					combine(once, twice, band_once[k], band_twice[k]);
+				}
+				const size_t b = bj * root_size + bi;
+				seen_once[2 * N + b] = once;
+				seen_twice[2 * N + b] = twice;
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------
+		// Scalar
+
+		void unitsSeenValuesScalar(const ValueMask* candidates, size_t root_size, ValueMask* seen_once, ValueMask* seen_twice) {
+			const size_t N = root_size * root_size;
+			ValueMask band_once[MAX_MASK_VALUES];
+			ValueMask band_twice[MAX_MASK_VALUES];
+
+			for (size_t j = 0; j < N; j++) {
+				seen_once[j] = 0;
+				seen_twice[j] = 0;
+			}
+
+			for (size_t bi = 0; bi < root_size; bi++) {
+				for (size_t j = 0; j < N; j++) {
+					band_once[j] = 0;
+					band_twice[j] = 0;
+				}
+
+				for (size_t i = bi * root_size; i < (bi + 1) * root_size; i++) {
+					const ValueMask* line = candidates + i * N;
+					ValueMask once = 0;
+					ValueMask twice = 0;
+					for (size_t j = 0; j < N; j++) {
+						accumulate(once, twice, line[j]);
+						accumulate(band_once[j], band_twice[j], line[j]);
+					}
+					seen_once[N + i] = once;
+					seen_twice[N + i] = twice;
+				}
+
+				foldBand(band_once, band_twice, root_size, bi, seen_once, seen_twice);
+			}
+		}
+
+		size_t findSingleCellScalar(const ValueMask* candidates, const GridCell* cells, size_t begin, size_t end) {
+			for (size_t k = begin; k < end; k++) {
+				if (isSingleCell(candidates, cells, k)) {
+					return k;
+				}
+			}
+			return end;
+		}
+
+#ifdef CANDIDATE_KERNELS_X86
+
+		inline size_t lowestBit(unsigned int bits) {
+#if defined(_MSC_VER)
+			unsigned long index = 0;
+			_BitScanForward(&index, bits);
+			return static_cast<size_t>(index);
+#else
+			return static_cast<size_t>(__builtin_ctz(bits));
+#endif
+		}
+
+		// ----------------------------------------------------------------------------------------------
+		// SSE4.1 : 2 masks per register
+
+		CANDIDATE_KERNELS_TARGET("sse4.1")
+		void unitsSeenValuesSse41(const ValueMask* candidates, size_t root_size, ValueMask* seen_once, ValueMask* seen_twice) {
+			const size_t N = root_size * root_size;
+			const size_t vector_end = N - N % 2;
+			ValueMask band_once[MAX_MASK_VALUES];
+			ValueMask band_twice[MAX_MASK_VALUES];
+			ValueMask lanes_once[2];
+			ValueMask lanes_twice[2];
+
+			for (size_t j = 0; j < N; j++) {
+				seen_once[j] = 0;
+				seen_twice[j] = 0;
+			}
+
+			for (size_t bi = 0; bi < root_size; bi++) {
+				for (size_t j = 0; j < N; j++) {
+					band_once[j] = 0;
+					band_twice[j] = 0;
+				}
+
+				for (size_t i = bi * root_size; i < (bi + 1) * root_size; i++) {
+					const ValueMask* line = candidates + i * N;
+					__m128i once = _mm_setzero_si128();
+					__m128i twice = _mm_setzero_si128();
+
+					for (size_t j = 0; j < vector_end; j += 2) {
+						const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + j));
+						__m128i b_once = _mm_loadu_si128(reinterpret_cast<const __m128i*>(band_once + j));
+						__m128i b_twice = _mm_loadu_si128(reinterpret_cast<const __m128i*>(band_twice + j));
+
+						b_twice = _mm_or_si128(b_twice, _mm_and_si128(b_once, values));
+						b_once = _mm_or_si128(b_once, values);
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(band_once + j), b_once);
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(band_twice + j), b_twice);
+
+						twice = _mm_or_si128(twice, _mm_and_si128(once, values));
+						once = _mm_or_si128(once, values);
+					}
+
+					ValueMask line_once = 0;
+					ValueMask line_twice = 0;
+					for (size_t j = vector_end; j < N; j++) {
+						accumulate(line_once, line_twice, line[j]);
+						accumulate(band_once[j], band_twice[j], line[j]);
+					}
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes_once), once);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes_twice), twice);
+					for (size_t l = 0; l < 2; l++) {
+						combine(line_once, line_twice, lanes_once[l], lanes_twice[l]);
+					}
+					seen_once[N + i] = line_once;
+					seen_twice[N + i] = line_twice;
+				}
+
+				foldBand(band_once, band_twice, root_size, bi, seen_once, seen_twice);
+			}
+		}
+
+		CANDIDATE_KERNELS_TARGET("sse4.1")
+		size_t findSingleCellSse41(const ValueMask* candidates, const GridCell* cells, size_t begin, size_t end) {
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i one = _mm_set1_epi64x(1);
+
+			size_t k = begin;
+			for (; k + 2 <= end; k += 2) {
+				const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidates + k));
+				const __m128i few = _mm_cmpeq_epi64(_mm_and_si128(values, _mm_sub_epi64(values, one)), zero);
+
+				uint16_t packed_cells = 0;
+				memcpy(&packed_cells, cells + k, sizeof(packed_cells));
+				const __m128i empty = _mm_cmpeq_epi64(_mm_cvtepu8_epi64(_mm_cvtsi32_si128(packed_cells)), zero);
+
+				const unsigned int bits = static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(few, empty))));
+				if (bits != 0) {
+					return k + lowestBit(bits);
+				}
+			}
+
+			return findSingleCellScalar(candidates, cells, k, end);
+		}
+
+		// ----------------------------------------------------------------------------------------------
+		// AVX2 : 4 masks per register
+
+		CANDIDATE_KERNELS_TARGET("avx2")
+		void unitsSeenValuesAvx2(const ValueMask* candidates, size_t root_size, ValueMask* seen_once, ValueMask* seen_twice) {
+			const size_t N = root_size * root_size;
+			const size_t vector_end = N - N % 4;
+			ValueMask band_once[MAX_MASK_VALUES];
+			ValueMask band_twice[MAX_MASK_VALUES];
+			ValueMask lanes_once[4];
+			ValueMask lanes_twice[4];
+
+			for (size_t j = 0; j < N; j++) {
+				seen_once[j] = 0;
+				seen_twice[j] = 0;
+			}
+
+			for (size_t bi = 0; bi < root_size; bi++) {
+				for (size_t j = 0; j < N; j++) {
+					band_once[j] = 0;
+					band_twice[j] = 0;
+				}
+
+				for (size_t i = bi * root_size; i < (bi + 1) * root_size; i++) {
+					const ValueMask* line = candidates + i * N;
+					__m256i once = _mm256_setzero_si256();
+					__m256i twice = _mm256_setzero_si256();
+
+					for (size_t j = 0; j < vector_end; j += 4) {
+						const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + j));
+						__m256i b_once = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(band_once + j));
+						__m256i b_twice = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(band_twice + j));
+
+						b_twice = _mm256_or_si256(b_twice, _mm256_and_si256(b_once, values));
+						b_once = _mm256_or_si256(b_once, values);
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(band_once + j), b_once);
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(band_twice + j), b_twice);
+
+						twice = _mm256_or_si256(twice, _mm256_and_si256(once, values));
+						once = _mm256_or_si256(once, values);
+					}
+
+					ValueMask line_once = 0;
+					ValueMask line_twice = 0;
+					for (size_t j = vector_end; j < N; j++) {
+						accumulate(line_once, line_twice, line[j]);
+						accumulate(band_once[j], band_twice[j], line[j]);
+					}
+
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes_once), once);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes_twice), twice);
+					for (size_t l = 0; l < 4; l++) {
+						combine(line_once, line_twice, lanes_once[l], lanes_twice[l]);
+					}
+					seen_once[N + i] = line_once;
+					seen_twice[N + i] = line_twice;
+				}
+
+				foldBand(band_once, band_twice, root_size, bi, seen_once, seen_twice);
+			}
+		}
+
+		CANDIDATE_KERNELS_TARGET("avx2")
+		size_t findSingleCellAvx2(const ValueMask* candidates, const GridCell* cells, size_t begin, size_t end) {
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i one = _mm256_set1_epi64x(1);
+
+			size_t k = begin;
+			for (; k + 4 <= end; k += 4) {
+				const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidates + k));
+				const __m256i few = _mm256_cmpeq_epi64(_mm256_and_si256(values, _mm256_sub_epi64(values, one)), zero);
+
+				uint32_t packed_cells = 0;
+				memcpy(&packed_cells, cells + k, sizeof(packed_cells));
+				const __m256i empty = _mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(static_cast<int>(packed_cells))), zero);
+
+				const unsigned int bits = static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_and_si256(few, empty))));
+				if (bits != 0) {
+					return k + lowestBit(bits);
+				}
+			}
+
+			return findSingleCellScalar(candidates, cells, k, end);
+		}
+
+		bool cpuSupports(const char* name) {
+#if defined(_MSC_VER)
+			int info[4] = { 0, 0, 0, 0 };
+			__cpuid(info, 1);
+			const bool sse41 = (info[2] & (1 << 19)) != 0;
+			// AVX2 also needs the system to save the YMM registers
+			const bool os_avx = ((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+			__cpuidex(info, 7, 0);
+			const bool avx2 = os_avx && ((info[1] & (1 << 5)) != 0);
+			return (strcmp(name, "avx2") == 0) ? avx2 : (strcmp(name, "sse4.1") == 0) ? sse41 : false;
+#else
+			__builtin_cpu_init();
+			if (strcmp(name, "avx2") == 0) {
+				return __builtin_cpu_supports("avx2");
+			} else if (strcmp(name, "sse4.1") == 0) {
+				return __builtin_cpu_supports("sse4.1");
+			}
+			return false;
+#endif
+		}
+
+#endif
+
+		const CandidateKernels SCALAR_KERNELS = { "scalar", unitsSeenValuesScalar, findSingleCellScalar };
+
+#ifdef CANDIDATE_KERNELS_X86
+		const CandidateKernels SSE41_KERNELS = { "sse4.1", unitsSeenValuesSse41, findSingleCellSse41 };
+		const CandidateKernels AVX2_KERNELS = { "avx2", unitsSeenValuesAvx2, findSingleCellAvx2 };
+
+		// From the best to the worst
+		const CandidateKernels* const ALL_KERNELS[] = { &AVX2_KERNELS, &SSE41_KERNELS, &SCALAR_KERNELS };
+#else
+		const CandidateKernels* const ALL_KERNELS[] = { &SCALAR_KERNELS };
+#endif
+
+		bool isSupported(const CandidateKernels& kernels) {
+#ifdef CANDIDATE_KERNELS_X86
+			return (&kernels == &SCALAR_KERNELS) || cpuSupports(kernels.Name);
+#else
+			return &kernels == &SCALAR_KERNELS;
+#endif
+		}
+
+		std::atomic<const CandidateKernels*> selected_kernels(nullptr);
+
+	}
+
+	const CandidateKernels& candidateKernels() {
+		const CandidateKernels* kernels = selected_kernels.load(std::memory_order_acquire);
+		if (kernels == nullptr) {
+			for (const CandidateKernels* candidate : ALL_KERNELS) {
+				if (isSupported(*candidate)) {
+					kernels = candidate;
+					break;
+				}
+			}
+			selected_kernels.store(kernels, std::memory_order_release);
+		}
+		return *kernels;
+	}
+
+	bool useCandidateKernels(const char* name) {
+		for (const CandidateKernels* candidate : ALL_KERNELS) {
+			if ((strcmp(candidate->Name, name) == 0) && isSupported(*candidate)) {
+				selected_kernels.store(candidate, std::memory_order_release);
+				return true;
+			}
+		}
+		return false;
+	}
+
+}
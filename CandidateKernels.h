@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BasicSquare.h"
+#include "ValueMask.h"
+
+namespace MagicSquares {
+
+	// Propagation kernels over the whole candidates grid (N * N masks, line i at i * N), with a scalar
+	// version and SIMD versions (SSE4.1, AVX2 on x86) chosen at run time from the CPU features.
+	typedef struct {
+		const char* Name;
+
+		// Values seen in at least one / two cells of each unit, in the unit order of RegulareSquare :
+		// u < N for j = u, N <= u < 2N for i = u - N, 2N + b for the block b (i band b % R, j band b / R).
+		// seen_once and seen_twice hold 3N masks.
+		void (*UnitsSeenValues)(const ValueMask* candidates, size_t root_size, ValueMask* seen_once, ValueMask* seen_twice);
+
+		// First empty cell (VOID_VALUE) with one or no candidate in [begin, end), end if none
+		size_t (*FindSingleCell)(const ValueMask* candidates, const GridCell* cells, size_t begin, size_t end);
+	} CandidateKernels;
+
+	// Kernels in use : the best ones the CPU supports, unless another set was asked for
+	const CandidateKernels& candidateKernels();
+
+	// Use the kernels named "scalar", "sse4.1" or "avx2" (benchmarks). False if the CPU can't run them.
+	bool useCandidateKernels(const char* name);
+
+}
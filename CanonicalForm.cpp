@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "CanonicalForm.h"
+
+namespace MagicSquares {
+
+	namespace {
+
+		const size_t MAX_LABELS = RegulareSquare::MAX_GRID_ROOT_SIZE * RegulareSquare::MAX_GRID_ROOT_SIZE + 1;
+
+		// Permutations of the N lines keeping the bands together : bands order, then lines order in each band
+		std::vector<std::vector<size_t> > linesPermutations(size_t root_size) {
+			std::vector<std::vector<size_t> > permutations;
+			std::vector<std::vector<size_t> > orders;
+			std::vector<size_t> order(root_size);
+			std::iota(order.begin(), order.end(), 0);
+			do {
+				orders.push_back(order);
+			} while (std::next_permutation(order.begin(), order.end()));
+
+			for (const std::vector<size_t>& bands_order : orders) {
+				std::vector<std::vector<size_t> > prefixes(1);
+				for (size_t slot = 0; slot < root_size; slot++) {
+					std::vector<std::vector<size_t> > next_prefixes;
+					for (const std::vector<size_t>& prefix : prefixes) {
+						for (const std::vector<size_t>& lines_order : orders) {
+							std::vector<size_t> lines = prefix;
+							for (size_t line : lines_order) {
+								lines.push_back(bands_order[slot] * root_size + line);
+							}
+							next_prefixes.push_back(lines);
+						}
+					}
+					prefixes.swap(next_prefixes);
+				}
+				permutations.insert(permutations.end(), prefixes.begin(), prefixes.end());
+			}
+			return permutations;
+		}
+
+		// Built once for each root size of the full search
+		const std::vector<std::vector<size_t> >& columnsOrders(size_t root_size) {
+			static const std::vector<std::vector<size_t> > orders[CanonicalForm::FULL_SEARCH_MAX_ROOT_SIZE + 1] = {
+				std::vector<std::vector<size_t> >(), linesPermutations(1), linesPermutations(2), linesPermutations(3)
+			};
+			return orders[root_size];
+		}
+
+		// Lowest grid over the lines orders, for a given columns order : the lines are placed one by one,
+		// the values relabeled in their order of appearance, and a branch stops as soon as its last line
+		// is above the same line of the best grid found
+		class FormSearch
+		{
+		public:
+
+			FormSearch(size_t root_size) :
+					mRootSize(root_size),
+					mSideSize(root_size * root_size),
+					mValues(nullptr),
+					mColumns(nullptr),
+					mCurrent(root_size * root_size * root_size * root_size, 0),
+					mHasBest(false),
+					mReplacements(0) {
+			};
+
+			void run(const GridCell* values, const std::vector<size_t>& columns) {
+				GridCell labels[MAX_LABELS];
+				memset(labels, 0, sizeof(labels));
+
+				mValues = values;
+				mColumns = columns.data();
+				this->placeLine(0, 0, 0, labels, 0, !mHasBest);
+			};
+
+			const std::vector<GridCell>& best() const {
+				return mBest;
+			};
+
+		private:
+
+			size_t                mRootSize;
+			size_t                mSideSize;
+			const GridCell*       mValues;     // line l, column c at l * N + c
+			const size_t*         mColumns;
+			std::vector<GridCell> mCurrent;
+			std::vector<GridCell> mBest;
+			bool                  mHasBest;
+			size_t                mReplacements;
+
+			// better : the lines already placed are below the ones of the best grid
+			void placeLine(size_t k, uint64_t used_lines, size_t band, const GridCell* labels, size_t labels_number, bool better) {
+				if (k == mSideSize) {
+					mBest = mCurrent;
+					mHasBest = true;
+					mReplacements++;
+					return;
+				}
+
+				// A new band starts every R lines
+				const bool new_band = (k % mRootSize) == 0;
+				const size_t first_line = new_band ? 0 : band * mRootSize;
+				const size_t end_line = new_band ? mSideSize : (band + 1) * mRootSize;
+
+				GridCell line_labels[MAX_LABELS];
+				GridCell* out = &mCurrent[k * mSideSize];
+
+				for (size_t l = first_line; l < end_line; l++) {
+					if ((used_lines & (uint64_t(1) << l)) ||
+						(new_band && (used_lines & (((uint64_t(1) << mRootSize) - 1) << ((l / mRootSize) * mRootSize))))) {
+						continue;
+					}
+
+					memcpy(line_labels, labels, (mSideSize + 1) * sizeof(GridCell));
+					size_t line_labels_number = labels_number;
+
+					int cmp = better ? -1 : 0;
+					for (size_t c = 0; (c < mSideSize) && (cmp <= 0); c++) {
+						GridCell V = mValues[l * mSideSize + mColumns[c]];
+						if (V != 0) {
+							if (line_labels[V] == 0) {
+								line_labels[V] = static_cast<GridCell>(++line_labels_number);
+							}
+							V = line_labels[V];
+						}
+						out[c] = V;
+
+						if (cmp == 0) {
+							const GridCell best_value = mBest[k * mSideSize + c];
+							cmp = (V < best_value) ? -1 : ((V > best_value) ? 1 : 0);
+						}
+					}
+					if (cmp > 0) {
+						continue;
+					}
+
+					const size_t replacements = mReplacements;
+					this->placeLine(k + 1, used_lines | (uint64_t(1) << l), l / mRootSize, line_labels, line_labels_number, cmp < 0);
+
+					// The best grid now starts with the lines placed here
+					if (mReplacements != replacements) {
+						better = false;
+					}
+				}
+			}
+
+		};
+
+		// Values relabeled in their order of appearance
+		std::vector<GridCell> relabeled(const GridCell* values, size_t cells_number) {
+			GridCell labels[MAX_LABELS];
+			memset(labels, 0, sizeof(labels));
+			size_t labels_number = 0;
+
+			std::vector<GridCell> form(values, values + cells_number);
+			for (GridCell& V : form) {
+				if (V != 0) {
+					if (labels[V] == 0) {
+						labels[V] = static_cast<GridCell>(++labels_number);
+					}
+					V = labels[V];
+				}
+			}
+			return form;
+		}
+
+	}
+
+	std::vector<GridCell> CanonicalForm::of(const RegulareSquare& grid) {
+		return of(grid.values(), grid.getGridRootSize());
+	}
+
+	std::vector<GridCell> CanonicalForm::of(const GridCell* values, size_t root_size) {
+		const size_t N = root_size * root_size;
+
+		std::vector<GridCell> transposed(N * N);
+		for (size_t i = 0; i < N; i++) {
+			for (size_t j = 0; j < N; j++) {
+				transposed[j * N + i] = values[i * N + j];
+			}
+		}
+
+		if (root_size > FULL_SEARCH_MAX_ROOT_SIZE) {
+			return std::min(relabeled(values, N * N), relabeled(transposed.data(), N * N));
+		}
+
+		// (R!)^(R + 1) columns orders (1296 on 9 * 9), each one searched on the grid and on its transposition
+		FormSearch search(root_size);
+		for (const std::vector<size_t>& columns : columnsOrders(root_size)) {
+			search.run(values, columns);
+			search.run(transposed.data(), columns);
+		}
+		return search.best();
+	}
+
+	uint64_t CanonicalForm::hash(const std::vector<GridCell>& form) {
+		uint64_t h = 0xCBF29CE484222325ULL;
+		h = (h ^ form.size()) * 0x100000001B3ULL;
+		for (GridCell V : form) {
+			h = (h ^ V) * 0x100000001B3ULL;
+		}
+		return h;
+	}
+
+}
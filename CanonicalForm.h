@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BasicSquare.h"
+#include "MagicSquare.h"
+
+namespace MagicSquares {
+
+	// Canonical form of a grid (solved or not) : the same values for all the grids equivalent under the
+	// transformations keeping a grid valid (values relabeling, bands and lines permutations in the bands,
+	// stacks and columns permutations in the stacks, transposition).
+	//
+	// Up to FULL_SEARCH_MAX_ROOT_SIZE, the form is the lowest grid (line by line) of the whole group, found by
+	// a search pruned on the lines already placed. Above, the group is far too large : the form only covers
+	// the relabeling and the transposition (equivalent grids may then have different forms, never the opposite).
+	class CanonicalForm
+	{
+	public:
+
+		static const size_t FULL_SEARCH_MAX_ROOT_SIZE = 3;
+
+		// N * N values (0 for a void cell)
+		static std::vector<GridCell> of(const RegulareSquare& grid);
+
+		static std::vector<GridCell> of(const GridCell* values, size_t root_size);
+
+		// 64 bits FNV-1a of the form : the same on every platform, it can be saved
+		static uint64_t hash(const std::vector<GridCell>& form);
+
+		static uint64_t hashOf(const RegulareSquare& grid) {
+			return hash(of(grid));
+		};
+
+	};
+
+}
@@ -0,0 +1,133 @@
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CANONICAL_INDEX_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "CanonicalIndex.h"
+
+namespace MagicSquares {
+
+	CanonicalIndex::CanonicalIndex() :
+			mLoadedNumber(0) {
+	}
+
+	CanonicalIndex::~CanonicalIndex() {
+		// Something to do ?
+	}
+
+	bool CanonicalIndex::open(const std::string& path) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		const size_t previous_size = mHashes.size();
+		if (!this->loadMapped(path)) {
+			this->loadStream(path);
+		}
+		mLoadedNumber += mHashes.size() - previous_size;
+
+		// A partial record at the end (interrupted write) is ignored : the next ones stay aligned on 8 bytes
+		mFile.close();
+		mFile.clear();
+		mFile.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+		if (!mFile.is_open()) {
+			mFile.clear();
+			mFile.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+		}
+		if (!mFile.is_open()) {
+			return false;
+		}
+		const std::streamoff file_size = mFile.tellp();
+		mFile.seekp(file_size - (file_size % static_cast<std::streamoff>(RECORD_SIZE)));
+		return true;
+	}
+
+	bool CanonicalIndex::insert(uint64_t hash) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (!mHashes.insert(hash).second) {
+			return false;
+		}
+		if (mFile.is_open()) {
+			unsigned char record[RECORD_SIZE];
+			for (size_t b = 0; b < RECORD_SIZE; b++) {
+				record[b] = static_cast<unsigned char>(hash >> (8 * b));
+			}
+			mFile.write(reinterpret_cast<const char*>(record), RECORD_SIZE);
+			mFile.flush();
+		}
+		return true;
+	}
+
+	bool CanonicalIndex::contains(uint64_t hash) const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mHashes.count(hash) != 0;
+	}
+
+	size_t CanonicalIndex::size() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mHashes.size();
+	}
+
+	void CanonicalIndex::addRecords(const unsigned char* records, size_t records_number) {
+		mHashes.reserve(mHashes.size() + records_number);
+		for (size_t r = 0; r < records_number; r++) {
+			const unsigned char* record = records + r * RECORD_SIZE;
+			uint64_t hash = 0;
+			for (size_t b = 0; b < RECORD_SIZE; b++) {
+				hash |= static_cast<uint64_t>(record[b]) << (8 * b);
+			}
+			mHashes.insert(hash);
+		}
+	}
+
+	void CanonicalIndex::loadStream(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		std::vector<unsigned char> records(4096 * RECORD_SIZE);
+		while (file) {
+			file.read(reinterpret_cast<char*>(records.data()), records.size());
+			this->addRecords(records.data(), static_cast<size_t>(file.gcount()) / RECORD_SIZE);
+		}
+	}
+
+#ifdef CANONICAL_INDEX_MMAP
+
+	bool CanonicalIndex::loadMapped(const std::string& path) {
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+
+		struct stat file_status;
+		if ((fstat(fd, &file_status) != 0) || !S_ISREG(file_status.st_mode) || (file_status.st_size == 0)) {
+			close(fd);
+			return false;
+		}
+
+		const size_t file_size = static_cast<size_t>(file_status.st_size);
+		void* data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+
+		// One pass from the beginning to the end
+		madvise(data, file_size, MADV_SEQUENTIAL);
+		this->addRecords(static_cast<const unsigned char*>(data), file_size / RECORD_SIZE);
+
+		munmap(data, file_size);
+		return true;
+	}
+
+#else
+
+	bool CanonicalIndex::loadMapped(const std::string&) {
+		return false;
+	}
+
+#endif
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace MagicSquares {
+
+	// Set of canonical form hashes (see CanonicalForm), shared by the threads of a batch.
+	// It can be kept in a file : 8 bytes per hash (little endian), and each new hash appended to it as soon as
+	// it is inserted (an interrupted batch loses nothing).
+	//
+	// The file is not searched in place : open reads the whole of it (through a memory mapping when the system
+	// allows it, released once read) into an in memory set, and the lookups only use the set. The file stays a
+	// plain append only log, but the memory grows with the whole history of the index : about 45 bytes per hash
+	// with std::unordered_set (node, allocation and bucket), some 450 MB for 10 million puzzles, and open takes
+	// a pass over the file. Past that, the file would have to become a hashed table probed on the disk.
+	class CanonicalIndex
+	{
+	public:
+
+		CanonicalIndex();
+
+		virtual ~CanonicalIndex();
+
+		CanonicalIndex(const CanonicalIndex&) = delete;
+		CanonicalIndex& operator=(const CanonicalIndex&) = delete;
+
+		// Load the hashes of path (created if missing) and append the new ones to it. False if it can't be written.
+		bool open(const std::string& path);
+
+		// False if the hash was already there
+		bool insert(uint64_t hash);
+
+		bool contains(uint64_t hash) const;
+
+		size_t size() const;
+
+		// Hashes read from the file by open
+		size_t getLoadedNumber() const {
+			return mLoadedNumber;
+		};
+
+	private:
+
+		mutable std::mutex           mMutex;
+		std::unordered_set<uint64_t> mHashes;
+		std::ofstream                mFile;
+		size_t                       mLoadedNumber;
+
+		// Hashes of a whole file, false if it can't be mapped
+		bool loadMapped(const std::string& path);
+
+		void loadStream(const std::string& path);
+
+		void addRecords(const unsigned char* records, size_t records_number);
+
+		static const size_t RECORD_SIZE = 8;
+
+	};
+
+}
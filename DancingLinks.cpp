@@ -0,0 +1,193 @@
+#include "DancingLinks.h"
+
+namespace MagicSquares {
+
+	DancingLinks::DancingLinks(size_t grid_root_size) :
+			mGridRootSize(grid_root_size),
+			mValuesNumber(grid_root_size * grid_root_size),
+			mColumnsNumber(4 * grid_root_size * grid_root_size * grid_root_size * grid_root_size),
+			mFirstCandidateNode(0),
+			mConsistent(true),
+			mValues(grid_root_size * grid_root_size * grid_root_size * grid_root_size, 0),
+			mMaxSolutions(0),
+			mSolutionsNumber(0),
+			mNodesNumber(0),
+			mStopped(false) {
+
+		const size_t N = mValuesNumber;
+		const size_t cells_number = N * N;
+
+		mFirstCandidateNode = 1 + mColumnsNumber;
+		const size_t nodes_number = mFirstCandidateNode + NODES_PER_CANDIDATE * cells_number * N;
+
+		mLeft.resize(nodes_number);
+		mRight.resize(nodes_number);
+		mUp.resize(nodes_number);
+		mDown.resize(nodes_number);
+		mColumn.resize(nodes_number);
+		mColumnSize.assign(1 + mColumnsNumber, 0);
+
+		// Root and column headers in a circular list
+		for (size_t c = 0; c <= mColumnsNumber; c++) {
+			mLeft[c] = static_cast<Link>((c == 0) ? mColumnsNumber : c - 1);
+			mRight[c] = static_cast<Link>((c == mColumnsNumber) ? 0 : c + 1);
+			mUp[c] = static_cast<Link>(c);
+			mDown[c] = static_cast<Link>(c);
+			mColumn[c] = static_cast<Link>(c);
+		}
+
+		// One row of 4 nodes per candidate
+		for (size_t i = 0; i < N; i++) {
+			for (size_t j = 0; j < N; j++) {
+				const size_t k = (i / mGridRootSize) + (j / mGridRootSize) * mGridRootSize;
+				for (size_t V = 1; V <= N; V++) {
+					const size_t columns[NODES_PER_CANDIDATE] = {
+						1 + i * N + j,                         // cell i,j holds a value
+						1 + cells_number + j * N + (V - 1),    // row J holds V
+						1 + 2 * cells_number + i * N + (V - 1),// column I holds V
+						1 + 3 * cells_number + k * N + (V - 1) // block K holds V
+					};
+
+					const size_t first_node = mFirstCandidateNode + NODES_PER_CANDIDATE * this->candidateIndex(i, j, V);
+					for (size_t t = 0; t < NODES_PER_CANDIDATE; t++) {
+						const size_t node = first_node + t;
+						const size_t c = columns[t];
+
+						mLeft[node] = static_cast<Link>(first_node + (t + NODES_PER_CANDIDATE - 1) % NODES_PER_CANDIDATE);
+						mRight[node] = static_cast<Link>(first_node + (t + 1) % NODES_PER_CANDIDATE);
+
+						// Append at the bottom of the column
+						mColumn[node] = static_cast<Link>(c);
+						mUp[node] = mUp[c];
+						mDown[node] = static_cast<Link>(c);
+						mDown[mUp[c]] = static_cast<Link>(node);
+						mUp[c] = static_cast<Link>(node);
+						mColumnSize[c]++;
+					}
+				}
+			}
+		}
+	}
+
+	DancingLinks::~DancingLinks() {
+		// Something to do ?
+	}
+
+	bool DancingLinks::setGrid(const std::vector<size_t>& values) {
+		std::vector<bool> covered(1 + mColumnsNumber, false);
+
+		for (size_t cell = 0; (cell < values.size()) && mConsistent; cell++) {
+			const size_t V = values[cell];
+			if (V != 0) {
+				mValues[cell] = V;
+
+				// Cover all the constraints satisfied by this candidate
+				const size_t first_node = mFirstCandidateNode + NODES_PER_CANDIDATE * this->candidateIndex(cell / mValuesNumber, cell % mValuesNumber, V);
+				for (size_t t = 0; (t < NODES_PER_CANDIDATE) && mConsistent; t++) {
+					const size_t c = mColumn[first_node + t];
+					if (covered[c]) {
+						// Already satisfied by another value
+						mConsistent = false;
+					} else {
+						this->cover(c);
+						covered[c] = true;
+					}
+				}
+			}
+		}
+
+		return mConsistent;
+	}
+
+	size_t DancingLinks::search(size_t max_solutions, const SolutionVisitor& visitor) {
+		mMaxSolutions = max_solutions;
+		mSolutionsNumber = 0;
+		mNodesNumber = 0;
+		mStopped = false;
+
+		if (mConsistent) {
+			this->recursiveSearch(visitor);
+		}
+
+		return mSolutionsNumber;
+	}
+
+	void DancingLinks::cover(size_t c) {
+		mRight[mLeft[c]] = mRight[c];
+		mLeft[mRight[c]] = mLeft[c];
+
+		for (size_t i = mDown[c]; i != c; i = mDown[i]) {
+			for (size_t j = mRight[i]; j != i; j = mRight[j]) {
+				mDown[mUp[j]] = mDown[j];
+				mUp[mDown[j]] = mUp[j];
+				mColumnSize[mColumn[j]]--;
+			}
+		}
+	}
+
+	void DancingLinks::uncover(size_t c) {
+		for (size_t i = mUp[c]; i != c; i = mUp[i]) {
+			for (size_t j = mLeft[i]; j != i; j = mLeft[j]) {
+				mColumnSize[mColumn[j]]++;
+				mDown[mUp[j]] = static_cast<Link>(j);
+				mUp[mDown[j]] = static_cast<Link>(j);
+			}
+		}
+
+		mRight[mLeft[c]] = static_cast<Link>(c);
+		mLeft[mRight[c]] = static_cast<Link>(c);
+	}
+
+	void DancingLinks::recursiveSearch(const SolutionVisitor& visitor) {
+
+		if (mRight[ROOT_NODE] == ROOT_NODE) {
+			// All the constraints are satisfied
+			mSolutionsNumber++;
+			if (visitor && !visitor(mValues)) {
+				mStopped = true;
+			}
+			if ((mMaxSolutions != 0) && (mSolutionsNumber >= mMaxSolutions)) {
+				mStopped = true;
+			}
+			return;
+		}
+
+		// Pick the constraint with the fewest candidates left
+		size_t best_column = mRight[ROOT_NODE];
+		for (size_t c = mRight[best_column]; (c != ROOT_NODE) && (mColumnSize[best_column] > 1); c = mRight[c]) {
+			if (mColumnSize[c] < mColumnSize[best_column]) {
+				best_column = c;
+			}
+		}
+
+		if (mColumnSize[best_column] == 0) {
+			// Dead end
+			return;
+		}
+
+		this->cover(best_column);
+
+		for (size_t r = mDown[best_column]; (r != best_column) && !mStopped; r = mDown[r]) {
+			const size_t candidate = (r - mFirstCandidateNode) / NODES_PER_CANDIDATE;
+			const size_t cell = candidate / mValuesNumber;
+
+			mNodesNumber++;
+			mValues[cell] = (candidate % mValuesNumber) + 1;
+
+			for (size_t j = mRight[r]; j != r; j = mRight[j]) {
+				this->cover(mColumn[j]);
+			}
+
+			this->recursiveSearch(visitor);
+
+			for (size_t j = mLeft[r]; j != r; j = mLeft[j]) {
+				this->uncover(mColumn[j]);
+			}
+
+			mValues[cell] = 0;
+		}
+
+		this->uncover(best_column);
+	}
+
+}
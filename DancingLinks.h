@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace MagicSquares {
+
+	// Exact cover model of a regular square solved with Knuth's Dancing Links (Algorithm X).
+	// Constraints (columns) : each cell holds one value, each row / column / block holds each value once.
+	// Candidates (rows) : value V in cell i,j.
+	// An instance is built for one grid : setGrid() then search().
+	class DancingLinks
+	{
+	public:
+
+		// Called with the N * N values of each solution (cell i,j at i * N + j), return false to stop the search
+		typedef std::function<bool(const std::vector<size_t>& values)> SolutionVisitor;
+
+		DancingLinks(size_t grid_root_size);
+
+		virtual ~DancingLinks();
+
+		// Select the candidates of the filled cells (i * N + j order, 0 for a void cell)
+		// Returns false if these values break a constraint
+		bool setGrid(const std::vector<size_t>& values);
+
+		// Enumerate the solutions, up to max_solutions (0 for all of them), returns the number of solutions found
+		size_t search(size_t max_solutions, const SolutionVisitor& visitor);
+
+		// Number of candidates tried by the last search
+		size_t getNodesNumber() const {
+			return mNodesNumber;
+		};
+
+	private:
+
+		typedef uint32_t Link;
+
+		static const size_t ROOT_NODE = 0;
+		static const size_t NODES_PER_CANDIDATE = 4;
+
+		size_t mGridRootSize;
+		size_t mValuesNumber;
+		size_t mColumnsNumber;
+		size_t mFirstCandidateNode;
+
+		std::vector<Link>   mLeft;
+		std::vector<Link>   mRight;
+		std::vector<Link>   mUp;
+		std::vector<Link>   mDown;
+		std::vector<Link>   mColumn;
+		std::vector<size_t> mColumnSize;
+
+		bool                mConsistent;
+		std::vector<size_t> mValues;       // clues, then the candidates selected by the search
+
+		size_t mMaxSolutions;
+		size_t mSolutionsNumber;
+		size_t mNodesNumber;
+		bool   mStopped;
+
+		size_t candidateIndex(size_t i, size_t j, size_t V) const {
+			return (i * mValuesNumber + j) * mValuesNumber + (V - 1);
+		};
+
+		void cover(size_t c);
+		void uncover(size_t c);
+
+		void recursiveSearch(const SolutionVisitor& visitor);
+
+	};
+
+}
@@ -1,522 +1,1992 @@
-#include <iostream>
-#include <ctime>
-#include <map>
-#include <unordered_set>
-
-#include "MagicSquare.h"
-
-namespace MagicSquares {
-
-	// CONVENTION : 
-	// - en minuscule les variables d'indexation des tableaux (entre 0 et N-1)
-	// - en majuscule les variables fonctionnelles (numros de ligne/colonne de 1  N
-
-	RegulareSquare::RegulareSquare(size_t grid_root_size) :
-			mGridRootSize(grid_root_size),
-			mGridHintsNumber(VOID_VALUE),
-			mInternalGrid(grid_root_size* grid_root_size, 0),
-		    mAllowedValuesMap(grid_root_size* grid_root_size, std::vector< std::set<size_t> >(grid_root_size* grid_root_size, std::set<size_t>())),
-			mSolved(false) {
-		
-		mMinAllowedValue = 1;
-		mMaxAllowedValue = mGridRootSize * mGridRootSize;
-
-		this->resetInternalGrids();
-
-	}
-
-	RegulareSquare::~RegulareSquare() {
-		// Something to do ?
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::completeGridWithHints(size_t hints_number) {
-
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-		size_t new_route_case = 0;
-		char   mbstr[100];
-
-		// Copy the grid in a new one
-		CellHypothesis h;
-
-		// Introduce entropy;
-		srand(time(0));
-
-		// First of all, complete a line randomly
-		size_t J = 1 + rand() % this->mMaxAllowedValue;
-		std::unordered_set<size_t> allowed_values;
-
-		for (size_t V = 1; V <= this->mMaxAllowedValue; V++) {
-			allowed_values.emplace(V);
-		}
-
-		size_t I = 1;
-		while (!allowed_values.empty() && (I <= this->mMaxAllowedValue)) {
-			auto it = allowed_values.begin();
-			std::advance(it, rand() % allowed_values.size());
-			this->setValue(I,J,*it);
-			allowed_values.erase(it);
-			I++;
-		}
-
-		// Find a first solution (unique or not)
-		this->solve(true);
-
-		// get the first solution
-		RegulareSquare sol = this->solutions()[0];
-
-		// create a scrambled "route" of cells to clear from a fresh grid
-		OrderedHypothesisMap hypothesis_map;
-		RegulareSquare       empty_grid(mGridRootSize);
-
-		empty_grid.buildHypothesisMap(hypothesis_map, true);
-		OrderedHypothesisMap::iterator it_cell = hypothesis_map.begin();
-
-		// Partie  optimiser
-		while (!sol.isSolved() || (sol.solutions().size() > 1) || (sol.filledCellsCount() > hints_number)) {
-
-			size_t old_value = sol.getValue(it_cell->second.I, it_cell->second.J);
-			sol.clearCell(it_cell->second.I, it_cell->second.J);
-
-			sol.solve(false);
-
-			// As soon as we diverge in solutions or there are none, we put back the deleted value
-			if (sol.solutions().size() != 1) {
-				RegulareSquare::ERROR_CODE err = sol.setValue(it_cell->second.I, it_cell->second.J, old_value);
-			}
-
-			it_cell++;
-
-			// If we have gone through all the route without results, we regenerate a random route and start again
-			if ((it_cell == hypothesis_map.end()) || (sol.filledCellsCount() < hints_number)) {
-				std::time_t result = std::time(nullptr);
-				std::strftime(mbstr, sizeof mbstr, "%c", std::localtime(&result));
-				new_route_case++;
-				std::cout << mbstr << " ########## build a new route #" << new_route_case << std::endl;
-				sol = this->solutions()[0];
-				empty_grid.buildHypothesisMap(hypothesis_map, true);
-				it_cell = hypothesis_map.begin();
-			}
-		}
-
-		// Set the internal grid from the computed result
-		this->resetInternalGrids();
-		this->setInternalGrid(sol.mInternalGrid);
-
-		return ret;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::solve(bool stop_on_first_solution) {
-
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-
-		// Switch back to unsolved status
-		mSolved = false;
-		mSolutions.clear();
-
-		// Copy the grid in a new one
-		RegulareSquare grid = *this;
-
-		// build the hypothesis
-		// Order the remaining void cells
-		OrderedHypothesisMap hypothesis_map;
-
-		grid.buildHypothesisMap(hypothesis_map);
-
-		if (!hypothesis_map.empty()) {
-			this->recursiveSolve(grid, hypothesis_map,hypothesis_map.begin(), stop_on_first_solution);
-		} else {
-			ret = ERR_NO_MORE_HYPOTHESIS;
-		}
-
-		return ret;
-	}
-
-	size_t RegulareSquare::getValue(size_t I, size_t J) {
-		return 	mInternalGrid[I - 1][J - 1];
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::setValue(size_t I, size_t J, size_t value) {
-	
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-		bool allowed = false;
-
-		ret = this->checkValueAllowed(I, J, value, allowed);
-
-		if (ret == ERR_OK) {
-			if (allowed) {
-				mInternalGrid[I - 1][J - 1] = value;
-				// Update allowed values for row
-				for (size_t i = 0; i < mMaxAllowedValue; i++) {
-					mAllowedValuesMap[i][J - 1].erase(value);
-				}
-				// Update allowed values for column
-				for (size_t j = 0; j < mMaxAllowedValue; j++) {
-					mAllowedValuesMap[I - 1][j].erase(value);
-				}
-
-				// Update allowed values for block (@todo : faire une fonction ?)
-				size_t I_min = ((I - 1) / mGridRootSize) * mGridRootSize + 1;
-				size_t I_max = I_min + mGridRootSize - 1;
-				size_t J_min = ((J - 1) / mGridRootSize) * mGridRootSize + 1;
-				size_t J_max = J_min + mGridRootSize - 1;
-
-				for (size_t V = 1; V <= mMaxAllowedValue; V++) {
-					// dans le cas d'un set on supprime toutes les possibilits pour la case
-					mAllowedValuesMap[I - 1][J - 1].clear();
-				}
-
-				for (size_t JJ = J_min; JJ <= J_max; JJ++) {
-					for (size_t II = I_min; II <= I_max; II++) {
-						mAllowedValuesMap[II - 1][JJ - 1].erase(value);
-					}
-				}
-
-				// Switch back to unsolved status
-				mSolved = false;
-				mSolutions.clear();
-
-			} else {
-				ret = ERR_FORBIDDEN_VALUE;
-			}
-		}
-
-		return ret;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::clearCell(size_t I, size_t J) {
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-		if (!this->isInGridBounds(I, J)) {
-			ret = ERR_OUT_OF_GRIDS_BOUNDS;
-		} else {
-
-			// Fast reset of the cell : reset the grid and set all values except this one
-			InternalGrid i_grid_copy = mInternalGrid;
-
-			i_grid_copy[I - 1][J - 1] = VOID_VALUE;
-
-			this->resetInternalGrids();
-			this->setInternalGrid(i_grid_copy);
-
-		}
-		return ret;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::checkValueAllowed(size_t I, size_t J, size_t value, bool & allowed) const {
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-
-		allowed = false;
-
-		if (!this->isInGridBounds(I, J)) {
-			ret = ERR_OUT_OF_GRIDS_BOUNDS;
-		} else if (!this->isInValuesBounds(value)) {
-			ret = ERR_OUT_OF_VALUES_BOUNDS;
-		} else {
-			// First check if the value is still in the possible velues list for I,J
-			allowed = (mAllowedValuesMap[I - 1][J - 1].count(value) > 0);
-			if (allowed) {
-				// If so, then check that setting this value wont head to
-				// an impossible grid solution (i.e. no more solution for another unsetted cell)
-
-				for (size_t i = 0; (i < mMaxAllowedValue) && allowed; i++) {
-					if ((i != (I - 1)) && (mAllowedValuesMap[i][J - 1].count(value) == 1) && (mAllowedValuesMap[i][J - 1].size() == 1)) {
-						allowed = false;
-						ret = ERR_UNABLE_TO_FILL_HINTS;
-					}
-				}
-
-				for (size_t j = 0; (j < mMaxAllowedValue) && allowed; j++) {
-					if ((j != (J - 1)) && (mAllowedValuesMap[I - 1][j].count(value) == 1) && (mAllowedValuesMap[I - 1][j].size() == 1)) {
-						allowed = false;
-						ret = ERR_UNABLE_TO_FILL_HINTS;
-					}
-				}
-
-				// Update allowed values for block (@todo : faire une fonction ?)
-				size_t I_min = ((I - 1) / mGridRootSize) * mGridRootSize + 1;
-				size_t I_max = I_min + mGridRootSize - 1;
-				size_t J_min = ((J - 1) / mGridRootSize) * mGridRootSize + 1;
-				size_t J_max = J_min + mGridRootSize - 1;
-
-				for (size_t JJ = J_min; (JJ <= J_max) && allowed; JJ++) {
-					for (size_t II = I_min; (II <= I_max) && allowed; II++) {
-						if (((II != I) && (JJ != J)) && (mAllowedValuesMap[II - 1][JJ - 1].count(value) == 1) && (mAllowedValuesMap[II - 1][JJ - 1].size() == 1)) {
-							allowed = false;
-							ret = ERR_UNABLE_TO_FILL_HINTS;
-						}
-					}
-				}
-			}
-
-		}
-
-		return ret;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::checkColumn(size_t I, bool& complete) const {
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-		complete = true;
-
-		if ((I <= mMaxAllowedValue) && (I >= mMinAllowedValue)) {
-			for (size_t j = 0; j < mMaxAllowedValue; j++) {
-				if (VOID_VALUE == mInternalGrid[I - 1][j]) {
-					complete = false;
-				}
-			}
-		} else {
-			ret = ERR_OUT_OF_GRIDS_BOUNDS;
-		}
-
-		return ret;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::checkRow(size_t J, bool& complete) const {
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-		complete = true;
-
-		if ((J <= mMaxAllowedValue) && (J >= mMinAllowedValue)) {
-			for (size_t i = 0; i < mMaxAllowedValue; i++) {
-				if (VOID_VALUE == mInternalGrid[i][J - 1]) {
-					complete = false;
-				}
-			}
-		}
-		else {
-			ret = ERR_OUT_OF_GRIDS_BOUNDS;
-		}
-
-		return ret;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::checkBlock(size_t K, bool& complete) const {
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-		complete = true;
-
-		size_t I_min = 0;
-		size_t I_max = 0;
-		size_t J_min = 0;
-		size_t J_max = 0;
-
-		if ((K <= mMaxAllowedValue) && (K >= mMinAllowedValue)) {
-
-			this->getBlockBounds(K, I_min, I_max, J_min, J_max);
-
-			for (size_t J = J_min; J <= J_max; J++) {
-				for (size_t I = I_min; I <= I_max; I++) {
-					if (VOID_VALUE == mInternalGrid[I - 1][J - 1]) {
-						complete = false;
-					}
-				}
-			}
-		}
-		else {
-			ret = ERR_OUT_OF_GRIDS_BOUNDS;
-		}
-
-		return ret;
-	}
-
-	bool RegulareSquare::isGridCompleted() const {
-
-		bool complete = true;
-
-		for (size_t K = mMinAllowedValue; K <= mMaxAllowedValue; K++) {
-			bool complete_block = false;
-			checkBlock(K, complete_block);
-			complete = complete && complete_block;
-			if (!complete_block) {
-				break;
-			}
-		}
-
-		return complete;
-	}
-
-	size_t RegulareSquare::filledCellsCount() const {
-		size_t ret = 0;
-
-		for (size_t I = mMinAllowedValue; I <= mMaxAllowedValue; I++) {
-			for (size_t J = mMinAllowedValue; J <= mMaxAllowedValue; J++) {
-				if (VOID_VALUE != mInternalGrid[I-1][J-1]) {
-					ret++;
-				}
-			}
-		}
-
-		return ret;
-	}
-
-	bool RegulareSquare::isInGridBounds(size_t i, size_t j) const {
-		return (i <= mMaxAllowedValue) && (i >= mMinAllowedValue) && (j <= mMaxAllowedValue) && (j >= mMinAllowedValue);
-	}
-
-	bool RegulareSquare::isInValuesBounds(size_t value) const {
-		return (value <= mMaxAllowedValue) && (value >= mMinAllowedValue);
-	}
-
-	void RegulareSquare::dump() const {
-
-		for (size_t j = 0; j < mMaxAllowedValue; j++) {
-			for (size_t i = 0; i < mMaxAllowedValue; i++) {
-				if (VOID_VALUE != mInternalGrid[i][j]) {
-					std::cout << " " << mInternalGrid[i][j];
-				} else {
-					std::cout << " " << "-";
-				}
-			}
-			std::cout << std::endl;
-		}
-
-	}
-
-	void RegulareSquare::dumpSolutions() const {
-		size_t s = 1;
-		for (auto it : mSolutions) {
-			std::cout << "-------------------------------- Solution #" << s << std::endl;
-			it.dump();
-			s++;
-		}
-	}
-
-	void RegulareSquare::dumpAllowedValuesNumbers() const {
-		for (size_t j = 0; j < mMaxAllowedValue; j++) {
-			for (size_t i = 0; i < mMaxAllowedValue; i++) {
-				std::cout << " " << mAllowedValuesMap[i][j].size();
-			}
-			std::cout << std::endl;
-		}
-	}
-
-	void RegulareSquare::resetInternalGrids() {
-		for (size_t i = 0; i < mMaxAllowedValue; i++) {
-			for (size_t j = 0; j < mMaxAllowedValue; j++) {
-				mInternalGrid[i][j] = VOID_VALUE;
-				for (size_t V = 1; V <= mMaxAllowedValue; V++) {
-					mAllowedValuesMap[i][j].emplace(V);
-				}
-			}
-		}
-	}
-
-	void RegulareSquare::setInternalGrid(const InternalGrid& grid) {
-		for (size_t I = 1; I <= mMaxAllowedValue; I++) {
-			for (size_t J = 1; J <= mMaxAllowedValue; J++) {
-				this->setValue(I,J,grid[I-1][J-1]);
-			}
-		}
-	}
-
-	void RegulareSquare::buildHypothesisMap(OrderedHypothesisMap& hypothesis_map, bool scrambled) const {
-		hypothesis_map.clear();
-		for (size_t j = 0; j < this->mMaxAllowedValue; j++) {
-			for (size_t i = 0; i < this->mMaxAllowedValue; i++) {
-				if (this->mAllowedValuesMap[i][j].size() > 0) {
-					CellHypothesis hypothesis;
-					hypothesis.I = i + 1;
-					hypothesis.J = j + 1;
-
-					std::unordered_set<size_t> allowed_values;
-					std::set<size_t> remainings_allowed_values = this->mAllowedValuesMap[i][j];
-					while (remainings_allowed_values.size() > 0) {
-						auto it = remainings_allowed_values.begin();
-						if (scrambled) {
-							std::advance(it, rand() % remainings_allowed_values.size());
-						}
-						allowed_values.emplace(*it);
-						remainings_allowed_values.erase(it);
-					}
-
-					// Build the ordered hypothesis (the lower number of possible values first)
-					for (auto possible_value : allowed_values) {
-						hypothesis.Values.emplace(possible_value);
-					}
-
-					if (this->mAllowedValuesMap[i][j].size() > 0) {
-						size_t weight;
-						if (!scrambled) {
-							weight = this->mAllowedValuesMap[i][j].size();
-						} else {
-							weight = rand() % (mMaxAllowedValue * mMaxAllowedValue);
-						}
-						hypothesis_map.emplace(weight, hypothesis);
-					}
-				}
-			}
-		}
-	}
-
-	bool RegulareSquare::recursiveSolve(const RegulareSquare & grid, 
-		                                const OrderedHypothesisMap & hypothesis_map, 
-		                                OrderedHypothesisMap::iterator next_hypothesis, 
-		                                bool stop_on_first_solution) {
-
-		bool solved = false;
-
-		std::unordered_set<size_t>::iterator it_first_value = next_hypothesis->second.Values.begin();
-
-		// Apply the first hypothesis to a grid copy
-		RegulareSquare grid_copy = grid;
-
-		RegulareSquare::ERROR_CODE ret = ERR_FORBIDDEN_VALUE;
-		while ((ret != ERR_OK) &&
-			   (!solved || !stop_on_first_solution) &&
-			   (it_first_value != next_hypothesis->second.Values.end())) {
-
-			RegulareSquare::ERROR_CODE ret = grid_copy.setValue(next_hypothesis->second.I, next_hypothesis->second.J, *it_first_value);
-
-			if (ret == ERR_OK) {
-				bool complete_grid = grid_copy.isGridCompleted();
-				
-				if (complete_grid) {
-					solved = true;
-					mSolved = true;
-					mSolutions.push_back(grid_copy);
-				} else {
-					OrderedHypothesisMap::iterator it = next_hypothesis;
-					it++;
-					if (it != hypothesis_map.end()) {
-						solved = recursiveSolve(grid_copy, hypothesis_map, it, stop_on_first_solution);
-						if ((!solved) || (!stop_on_first_solution)) {
-							// on tente la valeur possible suivante pour cette case
-							it_first_value++;
-							// on rinitialise la grille  l'tat prcdent
-							grid_copy = grid;
-						}
-					}
-				}
-			} else {
-				it_first_value++;
-			}
-		}
-
-		return solved;
-	}
-
-	RegulareSquare::ERROR_CODE RegulareSquare::getBlockBounds(size_t K, size_t& I_MIN, size_t& I_MAX, size_t& J_MIN, size_t& J_MAX) const {
-		RegulareSquare::ERROR_CODE ret = ERR_OK;
-
-		size_t i_min = 0;
-		size_t i_max = 0;
-		size_t j_min = 0;
-		size_t j_max = 0;
-
-		if ((K <= mMaxAllowedValue) && (K >= mMinAllowedValue)) {
-
-			i_min = ((K - 1) * mGridRootSize) % (mGridRootSize * mGridRootSize);
-			i_max = i_min + mGridRootSize - 1;
-
-			j_min = ((K - 1) / mGridRootSize) * mGridRootSize;
-			j_max = j_min + mGridRootSize - 1;
-
-			I_MIN = i_min + 1;
-			I_MAX = i_max + 1;
-			J_MIN = j_min + 1;
-			J_MAX = j_max + 1;
-		}
-		else {
-			ret = ERR_OUT_OF_GRIDS_BOUNDS;
-		}
-
-		return ret;
-	} 
-
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <random>
+#include <utility>
+
+#include "MagicSquare.h"
+#include "CandidateKernels.h"
+#include "DancingLinks.h"
+
+namespace MagicSquares {
+
+	// Working memory of a search. The grid copy, the trail and the hypothesis keep their storage when the search
+	// ends : the next searches of the thread on grids of the same size allocate nothing.
+	class RegulareSquare::SearchScratch
+	{
+	public:
+
+		std::unique_ptr<RegulareSquare> Grid;
+		SearchTrail                     Trail;
+		OrderedHypothesisMap            Hypothesis;
+		bool                            InUse = false;
+
+	};
+
+	// A free scratch of the calling thread for the time of a search, holding a copy of the searched grid.
+	// The trail of the search context takes the storage of the scratch trail until the end of the lease.
+	// One scratch per nested search (a solution visitor may search another grid). The release only clears
+	// the containers : the trail entries are plain values, this costs nothing whatever the search size.
+	class RegulareSquare::ScratchLease
+	{
+	public:
+
+		ScratchLease(const RegulareSquare& source, SearchTrail& trail) :
+				mScratch(nullptr),
+				mTrail(trail) {
+
+			static thread_local std::vector<std::unique_ptr<SearchScratch> > scratches;
+			for (auto& scratch : scratches) {
+				if (!scratch->InUse) {
+					mScratch = scratch.get();
+					break;
+				}
+			}
+			if (mScratch == nullptr) {
+				scratches.emplace_back(new SearchScratch());
+				mScratch = scratches.back().get();
+			}
+			mScratch->InUse = true;
+
+			if (mScratch->Grid) {
+				*mScratch->Grid = source;
+			} else {
+				mScratch->Grid.reset(new RegulareSquare(source));
+			}
+			mTrail.swap(mScratch->Trail);
+		};
+
+		~ScratchLease() {
+			mTrail.clear();
+			mTrail.swap(mScratch->Trail);
+			mScratch->Hypothesis.clear();
+			mScratch->Grid->mSolutions.clear();
+			mScratch->InUse = false;
+		};
+
+		ScratchLease(const ScratchLease&) = delete;
+		ScratchLease& operator=(const ScratchLease&) = delete;
+
+		RegulareSquare& grid() {
+			return *mScratch->Grid;
+		};
+
+		OrderedHypothesisMap& hypothesis() {
+			return mScratch->Hypothesis;
+		};
+
+	private:
+
+		SearchScratch* mScratch;
+		SearchTrail&   mTrail;
+
+	};
+
+	// CONVENTION : 
+	// - en minuscule les variables d'indexation des tableaux (entre 0 et N-1)
+	// - en majuscule les variables fonctionnelles (numéros de ligne/colonne de 1 à N
+
+	const char* const RegulareSquare::LINE_DIGITS = "123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz+/@";
+
+	RegulareSquare::RegulareSquare(size_t grid_root_size) :
+			mGridRootSize(isValidRootSize(grid_root_size) ? grid_root_size : 0),
+			mGridHintsNumber(VOID_VALUE),
+			mGenerationMaxSeconds(0.0),
+			mGenerationMaxChecks(0),
+			mUniquenessNodesLimit(0),
+			mProgressInterval(1.0),
+			mDifficultyMin(DIFFICULTY_EASY),
+			mDifficultyMax(DIFFICULTY_EXPERT),
+			mGridDifficulty(),
+			mClueSymmetry(SYMMETRY_NONE),
+			mInternalGrid(mGridRootSize, VOID_VALUE),
+			mAllowedValuesMap(mGridRootSize, 0),
+			mRowsMask(mGridRootSize * mGridRootSize, 0),
+			mColumnsMask(mGridRootSize * mGridRootSize, 0),
+			mBlocksMask(mGridRootSize * mGridRootSize, 0),
+			mFilledCellsCount(0),
+			mGridHash(0),
+			mSolutionCacheSize(DEFAULT_SOLUTION_CACHE_SIZE),
+			mSolverBackend(SOLVER_BACKTRACKING),
+			mSearchStrategy(SEARCH_MRV),
+			mPropagationTechniques(PROPAGATE_NAKED_SINGLES | PROPAGATE_HIDDEN_SINGLES),
+			mFillMethod(FILL_RANDOMIZED_SEARCH),
+			mSearchNodesNumber(0),
+			mVerbose(true),
+			mRandomGenerator(),
+			mSolved(false),
+			mSolutions(mGridRootSize * mGridRootSize * mGridRootSize * mGridRootSize),
+			mStatisticsEnabled(false) {
+
+		static_assert(MAX_GRID_ROOT_SIZE <= MAX_GRID_CELL_ROOT_SIZE, "grid values must fit in a GridCell");
+
+		// Different default seeds for the instances, without reading the random device each time
+		static const uint64_t process_seed = (static_cast<uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+		static std::atomic<uint64_t> instances_number(0);
+		this->setRandomSeed(process_seed ^ (++instances_number * 0x9E3779B97F4A7C15ULL));
+
+		mMinAllowedValue = 1;
+		mMaxAllowedValue = mGridRootSize * mGridRootSize;
+
+		// From 25 * 25, a few uniqueness checks can explode : bound them by default
+		if (mGridRootSize >= 5) {
+			mUniquenessNodesLimit = BIG_GRID_UNIQUENESS_NODES_LIMIT;
+		}
+
+		this->resetInternalGrids();
+		this->resetStatistics();
+
+	}
+
+	RegulareSquare::RegulareSquare(size_t grid_root_size, const RandomGenerator& random_generator) :
+			RegulareSquare(grid_root_size) {
+
+		mRandomGenerator = random_generator;
+	}
+
+	RegulareSquare::~RegulareSquare() {
+		// Something to do ?
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::completeGridWithHints(size_t hints_number) {
+
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		size_t new_route_case = 0;
+		char   mbstr[100];
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		// First of all, get a random solved grid (entropy comes from the instance random generator)
+		ret = this->generateFilteredSolvedGrid();
+		if (ret != ERR_OK) {
+			return ret;
+		}
+
+		GenerationState state;
+		state.Start = std::chrono::steady_clock::now();
+		state.LastProgress = state.Start;
+		state.Progress.HintsNumber = mMaxAllowedValue * mMaxAllowedValue;
+		state.Progress.LowestHintsNumber = state.Progress.HintsNumber;
+		state.Progress.UniquenessChecks = 0;
+		state.Progress.RouteRestarts = 0;
+		state.Progress.DifficultyRejects = 0;
+		state.Progress.Seconds = 0.0;
+		state.BudgetOver = false;
+		state.Orbits = this->clueOrbits();
+
+		// One table per thread, allocated by its first generation and emptied for each one
+		static thread_local SolutionCountCache cache;
+		cache.reset(mSolutionCacheSize);
+		state.Cache = (mSolutionCacheSize != 0) ? &cache : nullptr;
+
+		// The searches of the puzzles count in their own statistics, added to these ones after each check
+		RegulareSquare solved_grid = *this;
+		solved_grid.resetStatistics();
+		state.Solution = solved_grid.mInternalGrid.data();
+
+		// The cells out of the clue mask are cleared first : the solved grid must keep a unique solution without them
+		RegulareSquare first_puzzle = solved_grid;
+		for (size_t attempts = 1; !this->clearOutOfMask(first_puzzle); attempts++) {
+			state.Progress.UniquenessChecks++;
+			if ((attempts >= MAX_MASK_SOLVED_GRIDS) ||
+				((mGenerationMaxChecks != 0) && (state.Progress.UniquenessChecks >= mGenerationMaxChecks)) ||
+				((mGenerationMaxSeconds > 0.0) && (std::chrono::duration<double>(std::chrono::steady_clock::now() - state.Start).count() >= mGenerationMaxSeconds))) {
+				mGridHintsNumber = this->filledCellsCount();
+				return ERR_UNABLE_TO_FILL_HINTS;
+			}
+
+			this->resetInternalGrids();
+			ret = this->generateFilteredSolvedGrid();
+			if (ret != ERR_OK) {
+				return ret;
+			}
+			solved_grid = *this;
+			solved_grid.resetStatistics();
+			state.Solution = solved_grid.mInternalGrid.data();
+			first_puzzle = solved_grid;
+		}
+
+		// First descent : clear the orbits along a random route while the solution stays unique
+		RegulareSquare sol = first_puzzle;
+		this->removeClues(sol, hints_number, state);
+
+		RegulareSquare best = sol;
+		state.Progress.LowestHintsNumber = best.filledCellsCount();
+		bool found = (sol.filledCellsCount() <= hints_number) && this->isInDifficultyBand(sol, state);
+		if (mStatisticsEnabled) {
+			mStatistics.GridCopiesNumber += 3;
+		}
+
+		// Local search between the minimal puzzles : instead of starting again from the solved grid when the route
+		// is exhausted, give back a few clues and clear the cells along a new route. Moves keeping the clues number
+		// are accepted (the search drifts on the plateau), the full restart only comes after a long stall.
+		// The candidate is assigned at each move : its grids keep their storage
+		// An unreachable hints number ends after MAX_STALLED_ROUTES routes without a new lowest puzzle
+		size_t stalled_moves = 0;
+		size_t stalled_routes = 0;
+		RegulareSquare candidate = sol;
+		while (!found && !state.BudgetOver) {
+
+			const bool restart = (stalled_moves >= MAX_STALLED_MOVES);
+			if (restart && (++stalled_routes > MAX_STALLED_ROUTES)) {
+				break;
+			}
+			candidate = restart ? first_puzzle : sol;
+
+			if (restart) {
+				new_route_case++;
+				stalled_moves = 0;
+				state.Progress.RouteRestarts++;
+				if (mVerbose) {
+					std::time_t result = std::time(nullptr);
+					std::strftime(mbstr, sizeof mbstr, "%c", std::localtime(&result));
+					std::cout << mbstr << " ########## build a new route #" << new_route_case << " (lowest " << best.filledCellsCount() << " hints)" << std::endl;
+				}
+				if (mStatisticsEnabled) {
+					mStatistics.RouteRestartsNumber++;
+				}
+			} else {
+				this->restoreClues(candidate, PERTURBATION_CLUES_NUMBER, state);
+			}
+
+			this->removeClues(candidate, hints_number, state);
+
+			stalled_moves = (candidate.filledCellsCount() < sol.filledCellsCount()) ? 0 : stalled_moves + 1;
+			if (restart || (candidate.filledCellsCount() <= sol.filledCellsCount())) {
+				sol = candidate;
+
+				// Down to the hints number : done if its difficulty is in the band, otherwise the moves go on from it
+				if ((sol.filledCellsCount() <= hints_number) && this->isInDifficultyBand(sol, state)) {
+					best = sol;
+					found = true;
+				}
+			}
+			if (sol.filledCellsCount() < best.filledCellsCount()) {
+				best = sol;
+				state.Progress.LowestHintsNumber = best.filledCellsCount();
+				stalled_routes = 0;
+			}
+			if (mStatisticsEnabled) {
+				mStatistics.GridCopiesNumber += 2;
+			}
+		}
+
+		if (mStatisticsEnabled) {
+			mStatistics.MinimizationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - state.Start).count();
+			mStatistics.CacheHitsNumber += cache.getHitsNumber();
+			mStatistics.CacheMissesNumber += cache.getMissesNumber();
+		}
+
+		// Last report
+		if (mProgressCallback) {
+			state.Progress.HintsNumber = best.filledCellsCount();
+			state.Progress.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.Start).count();
+			mProgressCallback(state.Progress);
+		}
+
+		// Out of budget or stalled : the grid is the lowest puzzle found (maybe out of the difficulty band)
+		mGridHintsNumber = best.filledCellsCount();
+		if (!found) {
+			ret = ERR_UNABLE_TO_FILL_HINTS;
+		}
+		best.gradeDifficulty(mGridDifficulty, state.Solution);
+
+		// Set the internal grid from the computed result
+		this->resetInternalGrids();
+		this->setInternalGrid(best.mInternalGrid);
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::generateFilteredSolvedGrid() {
+
+		RegulareSquare::ERROR_CODE ret = this->generateSolvedGrid(mFillMethod);
+
+		for (size_t attempts = 1; (ret == ERR_OK) && mSolvedGridFilter && !mSolvedGridFilter(*this); attempts++) {
+			if (attempts >= MAX_FILTERED_SOLVED_GRIDS) {
+				mGridHintsNumber = this->filledCellsCount();
+				return ERR_UNABLE_TO_FILL_HINTS;
+			}
+			this->resetInternalGrids();
+			ret = this->generateSolvedGrid(mFillMethod);
+		}
+
+		return ret;
+	}
+
+	void RegulareSquare::removeClues(RegulareSquare& puzzle, size_t hints_number, GenerationState& state) {
+
+		// A new random route through the orbits still holding their clues
+		std::vector<size_t> route;
+		for (size_t o = 0; o < state.Orbits.size(); o++) {
+			if (VOID_VALUE != puzzle.mInternalGrid.data()[state.Orbits[o][0]]) {
+				route.push_back(o);
+			}
+		}
+		this->shuffle(route);
+
+		for (size_t k = 0; (k < route.size()) && (puzzle.filledCellsCount() > hints_number) && !state.BudgetOver; k++) {
+			const std::vector<size_t>& orbit = state.Orbits[route[k]];
+			if (puzzle.filledCellsCount() < hints_number + orbit.size()) {
+				// Would go below the hints number
+				continue;
+			}
+
+			for (size_t c : orbit) {
+				puzzle.clearCell(c / mMaxAllowedValue + 1, c % mMaxAllowedValue + 1);
+			}
+
+			// The puzzle had a unique solution : with a single cleared cell, it keeps it unless another value fits there.
+			// A whole orbit is checked by a single uniqueness search.
+			// On big grids a check may take too long : past the nodes limit, the clues are kept (still unique)
+			bool keep_clues = false;
+			SolutionCountCache::SOLUTIONS_VERDICT verdict = SolutionCountCache::UNIQUE_SOLUTION;
+			const bool cached = (state.Cache != nullptr) && state.Cache->find(puzzle.getGridHash(), verdict);
+			if (cached) {
+				keep_clues = (verdict != SolutionCountCache::UNIQUE_SOLUTION);
+			} else {
+				if (orbit.size() == 1) {
+					keep_clues = !puzzle.isValueForced(orbit[0] / mMaxAllowedValue + 1, orbit[0] % mMaxAllowedValue + 1,
+													   state.Solution[orbit[0]], mUniquenessNodesLimit);
+				} else {
+					keep_clues = !puzzle.hasUniqueSolution(mUniquenessNodesLimit);
+				}
+
+				// An unfinished check says nothing about the puzzle : not remembered
+				if ((state.Cache != nullptr) && ((mUniquenessNodesLimit == 0) || (puzzle.getSearchNodesNumber() < mUniquenessNodesLimit))) {
+					state.Cache->insert(puzzle.getGridHash(), keep_clues ? SolutionCountCache::MULTIPLE_SOLUTIONS : SolutionCountCache::UNIQUE_SOLUTION);
+				}
+			}
+
+			if (!keep_clues && (mDifficultyMax < DIFFICULTY_EXPERT) && (puzzle.difficultyLevel(state.Solution) > mDifficultyMax)) {
+				// Already too hard, and removing more clues won't make it easier : put them back now
+				keep_clues = true;
+				state.Progress.DifficultyRejects++;
+			}
+
+			// As soon as we diverge in solutions, we put back the deleted values
+			if (keep_clues) {
+				for (size_t c : orbit) {
+					puzzle.setValue(c / mMaxAllowedValue + 1, c % mMaxAllowedValue + 1, state.Solution[c]);
+				}
+			}
+
+			// A cached answer costs nothing : it doesn't count in the checks budget
+			if (!cached) {
+				state.Progress.UniquenessChecks++;
+			}
+			if (mStatisticsEnabled) {
+				mStatistics.ClueRemovalsNumber++;
+				this->addStatistics(puzzle.mStatistics);
+				puzzle.resetStatistics();
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			const double seconds = std::chrono::duration<double>(now - state.Start).count();
+
+			state.BudgetOver = ((mGenerationMaxChecks != 0) && (state.Progress.UniquenessChecks >= mGenerationMaxChecks)) ||
+							   ((mGenerationMaxSeconds > 0.0) && (seconds >= mGenerationMaxSeconds));
+
+			if (mProgressCallback && (std::chrono::duration<double>(now - state.LastProgress).count() >= mProgressInterval)) {
+				state.LastProgress = now;
+				state.Progress.HintsNumber = puzzle.filledCellsCount();
+				if (state.Progress.HintsNumber < state.Progress.LowestHintsNumber) {
+					state.Progress.LowestHintsNumber = state.Progress.HintsNumber;
+				}
+				state.Progress.Seconds = seconds;
+				mProgressCallback(state.Progress);
+			}
+		}
+	}
+
+	bool RegulareSquare::isInDifficultyBand(const RegulareSquare& puzzle, GenerationState& state) const {
+		if ((mDifficultyMin == DIFFICULTY_EASY) && (mDifficultyMax == DIFFICULTY_EXPERT)) {
+			// Any puzzle : no grading
+			return true;
+		}
+
+		const DIFFICULTY_LEVEL level = puzzle.difficultyLevel(state.Solution);
+		if ((level < mDifficultyMin) || (level > mDifficultyMax)) {
+			state.Progress.DifficultyRejects++;
+			return false;
+		}
+		return true;
+	}
+
+	void RegulareSquare::restoreClues(RegulareSquare& puzzle, size_t clues_number, const GenerationState& state) {
+		std::vector<size_t> void_orbits;
+		for (size_t o = 0; o < state.Orbits.size(); o++) {
+			if (VOID_VALUE == puzzle.mInternalGrid.data()[state.Orbits[o][0]]) {
+				void_orbits.push_back(o);
+			}
+		}
+		this->shuffle(void_orbits);
+
+		size_t restored_clues = 0;
+		for (size_t k = 0; (restored_clues < clues_number) && (k < void_orbits.size()); k++) {
+			for (size_t c : state.Orbits[void_orbits[k]]) {
+				puzzle.setValue(c / mMaxAllowedValue + 1, c % mMaxAllowedValue + 1, state.Solution[c]);
+				restored_clues++;
+			}
+		}
+	}
+
+	size_t RegulareSquare::symmetricCell(size_t c) const {
+		const size_t N = mMaxAllowedValue;
+		const size_t i = c / N;
+		const size_t j = c % N;
+		switch (mClueSymmetry) {
+		case SYMMETRY_ROTATIONAL_180:
+			return (N - 1 - i) * N + (N - 1 - j);
+		case SYMMETRY_DIAGONAL:
+			return j * N + i;
+		case SYMMETRY_HORIZONTAL_MIRROR:
+			return i * N + (N - 1 - j);
+		case SYMMETRY_VERTICAL_MIRROR:
+			return (N - 1 - i) * N + j;
+		default:
+			return c;
+		}
+	}
+
+	bool RegulareSquare::isInClueMask(size_t c) const {
+		// The mask is row by row
+		const size_t k = (c % mMaxAllowedValue) * mMaxAllowedValue + c / mMaxAllowedValue;
+		return (k >= mClueMask.size()) || mClueMask[k];
+	}
+
+	bool RegulareSquare::isClueCell(size_t c) const {
+		return this->isInClueMask(c) && this->isInClueMask(this->symmetricCell(c));
+	}
+
+	size_t RegulareSquare::getAsymmetricMaskCellsNumber() const {
+		size_t cells_number = 0;
+		for (size_t c = 0; c < mMaxAllowedValue * mMaxAllowedValue; c++) {
+			if (this->isInClueMask(c) && !this->isClueCell(c)) {
+				cells_number++;
+			}
+		}
+		return cells_number;
+	}
+
+	std::vector<std::vector<size_t> > RegulareSquare::clueOrbits() const {
+		const size_t N = mMaxAllowedValue;
+
+		std::vector<std::vector<size_t> > orbits;
+		std::vector<bool> visited(N * N, false);
+
+		for (size_t c = 0; c < N * N; c++) {
+			if (visited[c] || !this->isClueCell(c)) {
+				continue;
+			}
+
+			// All the symmetries are involutions : an orbit is a cell and its image (a clue cell too)
+			const size_t image = this->symmetricCell(c);
+			std::vector<size_t> orbit(1, c);
+			visited[c] = true;
+			if (image != c) {
+				orbit.push_back(image);
+				visited[image] = true;
+			}
+			orbits.push_back(orbit);
+		}
+
+		return orbits;
+	}
+
+	bool RegulareSquare::clearOutOfMask(RegulareSquare& puzzle) {
+		if (mClueMask.empty()) {
+			return true;
+		}
+
+		for (size_t c = 0; c < mMaxAllowedValue * mMaxAllowedValue; c++) {
+			if (!this->isClueCell(c)) {
+				puzzle.clearCell(c / mMaxAllowedValue + 1, c % mMaxAllowedValue + 1);
+			}
+		}
+		return puzzle.hasUniqueSolution(mUniquenessNodesLimit);
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::generateSolvedGrid(FILL_METHOD method) {
+
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		auto start = std::chrono::steady_clock::now();
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		if (method == FILL_PATTERN_TRANSFORM) {
+			this->fillFromPattern();
+		} else if (!this->isGridCompleted()) {
+			// Heavy tailed search : restart with a new random order and a doubled budget when stuck
+			const size_t MAX_RESTARTS = 16;
+			size_t nodes_limit = 4 * mMaxAllowedValue * mMaxAllowedValue;
+
+			ret = ERR_UNABLE_TO_FILL_HINTS;
+			mSolutions.clear();
+
+			for (size_t restart = 0; (restart < MAX_RESTARTS) && mSolutions.empty(); restart++) {
+				SearchContext context;
+				context.SolutionsLimit = 1;
+				context.SolutionsNumber = 0;
+				context.StoreSolutions = true;
+				context.Cancel = nullptr;
+				context.NodesLimit = nodes_limit;
+				context.RandomizeValues = true;
+				context.Visitor = nullptr;
+				context.Statistics = this->statistics();
+				context.Depth = 0;
+
+				mSearchNodesNumber = 0;
+
+				ScratchLease scratch(*this, context.Trail);
+				RegulareSquare& grid = scratch.grid();
+				if (mStatisticsEnabled) {
+					mStatistics.GridCopiesNumber++;
+				}
+				if (!grid.propagate(&context.Trail, context.Statistics)) {
+					// Inconsistent values : no need to try again
+					break;
+				}
+				this->recursiveSolveMRV(grid, context);
+
+				nodes_limit *= 2;
+			}
+
+			if (!mSolutions.empty()) {
+				const GridCell* solution_values = mSolutions[0];
+				std::vector<size_t> values(solution_values, solution_values + mSolutions.getCellsNumber());
+				this->loadValues(values);
+				ret = ERR_OK;
+			}
+		}
+
+		if (mStatisticsEnabled) {
+			mStatistics.FillSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::solve(bool stop_on_first_solution) {
+
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		// Switch back to unsolved status
+		mSolved = false;
+		mSolutions.clear();
+
+		mSearchNodesNumber = 0;
+
+		if (this->isGridCompleted()) {
+			ret = ERR_NO_MORE_HYPOTHESIS;
+		} else {
+			this->runSearch(stop_on_first_solution ? 1 : 0, true);
+		}
+
+		return ret;
+	}
+
+	size_t RegulareSquare::countSolutions(size_t limit) {
+
+		mSearchNodesNumber = 0;
+
+		if (!this->isValid()) {
+			return 0;
+		}
+
+		// A completed grid is its own (and only) solution
+		if (this->isGridCompleted()) {
+			return 1;
+		}
+
+		return this->runSearch(limit, false);
+	}
+
+	bool RegulareSquare::hasUniqueSolution() {
+		// No need to look further than a second solution
+		return (this->countSolutions(2) == 1);
+	}
+
+	bool RegulareSquare::hasUniqueSolution(size_t nodes_limit) {
+		if ((nodes_limit == 0) || (mSolverBackend == SOLVER_DANCING_LINKS)) {
+			return this->hasUniqueSolution();
+		}
+
+		mSearchNodesNumber = 0;
+		return (this->runSearch(2, false, nullptr, nodes_limit) == 1) && (mSearchNodesNumber < nodes_limit);
+	}
+
+	bool RegulareSquare::isValueForced(size_t I, size_t J, size_t value, size_t nodes_limit) {
+
+		if (!this->isValid()) {
+			return false;
+		}
+
+		// The exact cover backend only reads the values : count up to the second solution
+		if (mSolverBackend == SOLVER_DANCING_LINKS) {
+			return this->hasUniqueSolution();
+		}
+
+		// Any other solution has another value in I,J : forbid this one and look for a single solution
+		const ValueMask value_bit = valueBit(value);
+		ValueMask& allowed_values = mAllowedValuesMap[I - 1][J - 1];
+		const ValueMask saved_values = allowed_values;
+
+		allowed_values &= ~value_bit;
+		mSearchNodesNumber = 0;
+		const bool forced = (this->runSearch(1, false, nullptr, nodes_limit) == 0) &&
+							((nodes_limit == 0) || (mSearchNodesNumber < nodes_limit));
+		allowed_values = saved_values;
+
+		return forced;
+	}
+
+	size_t RegulareSquare::enumerateSolutions(const SolutionVisitor& visitor, size_t limit) {
+
+		mSearchNodesNumber = 0;
+
+		if (!this->isValid()) {
+			return 0;
+		}
+
+		if (this->isGridCompleted()) {
+			visitor(mInternalGrid.data());
+			return 1;
+		}
+
+		return this->runSearch(limit, false, &visitor);
+	}
+
+	RegulareSquare RegulareSquare::solution(size_t index) const {
+		const GridCell* solution_values = mSolutions[index];
+
+		RegulareSquare grid(mGridRootSize, mRandomGenerator);
+		grid.setVerbose(mVerbose);
+		grid.loadValues(std::vector<size_t>(solution_values, solution_values + mSolutions.getCellsNumber()));
+		return grid;
+	}
+
+	std::vector<RegulareSquare> RegulareSquare::solutions() const {
+		std::vector<RegulareSquare> grids;
+		grids.reserve(mSolutions.size());
+		for (size_t s = 0; s < mSolutions.size(); s++) {
+			grids.push_back(this->solution(s));
+		}
+		return grids;
+	}
+
+	size_t RegulareSquare::getValue(size_t I, size_t J) {
+		return 	mInternalGrid[I - 1][J - 1];
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::setValue(size_t I, size_t J, size_t value) {
+	
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		bool allowed = false;
+
+		ret = this->checkValueAllowed(I, J, value, allowed);
+
+		if (ret == ERR_OK) {
+			if (allowed) {
+				this->placeValue(I - 1, J - 1, value, nullptr);
+
+				// Switch back to unsolved status
+				mSolved = false;
+				mSolutions.clear();
+
+			} else {
+				ret = ERR_FORBIDDEN_VALUE;
+			}
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::clearCell(size_t I, size_t J) {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		if (!this->isInGridBounds(I, J)) {
+			ret = ERR_OUT_OF_GRIDS_BOUNDS;
+		} else {
+
+			const size_t i = I - 1;
+			const size_t j = J - 1;
+			const size_t V = mInternalGrid[i][j];
+
+			if (V != VOID_VALUE) {
+				// Incremental reset of the cell : a value appears at most once in a unit,
+				// so the units masks tell where V becomes allowed again
+				const ValueMask value_bit = valueBit(V);
+
+				mInternalGrid[i][j] = VOID_VALUE;
+				mFilledCellsCount--;
+				mGridHash ^= cellKey(i * mMaxAllowedValue + j, V);
+				mRowsMask[j] &= ~value_bit;
+				mColumnsMask[i] &= ~value_bit;
+				mBlocksMask[this->blockIndex(i, j)] &= ~value_bit;
+
+				mAllowedValuesMap[i][j] = fullMask(mMaxAllowedValue) & ~(mRowsMask[j] | mColumnsMask[i] | mBlocksMask[this->blockIndex(i, j)]);
+
+				// Update allowed values for row, column and block
+				for (size_t ii = 0; ii < mMaxAllowedValue; ii++) {
+					this->restoreCandidate(ii, j, value_bit);
+				}
+				for (size_t jj = 0; jj < mMaxAllowedValue; jj++) {
+					this->restoreCandidate(i, jj, value_bit);
+				}
+				size_t i_min = (i / mGridRootSize) * mGridRootSize;
+				size_t j_min = (j / mGridRootSize) * mGridRootSize;
+
+				for (size_t jj = j_min; jj < j_min + mGridRootSize; jj++) {
+					for (size_t ii = i_min; ii < i_min + mGridRootSize; ii++) {
+						this->restoreCandidate(ii, jj, value_bit);
+					}
+				}
+
+				// Switch back to unsolved status
+				mSolved = false;
+				mSolutions.clear();
+			}
+
+		}
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::checkValueAllowed(size_t I, size_t J, size_t value, bool & allowed) const {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		allowed = false;
+
+		if (!this->isInGridBounds(I, J)) {
+			ret = ERR_OUT_OF_GRIDS_BOUNDS;
+		} else if (!this->isInValuesBounds(value)) {
+			ret = ERR_OUT_OF_VALUES_BOUNDS;
+		} else {
+			ret = this->checkCandidate(I - 1, J - 1, value, allowed);
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::checkCandidate(size_t i, size_t j, size_t V, bool& allowed) const {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		const ValueMask value_bit = valueBit(V);
+
+		// First check if the value is still in the possible velues list for i,j
+		allowed = ((mAllowedValuesMap[i][j] & value_bit) != 0);
+		if (allowed) {
+			// If so, then check that setting this value wont head to
+			// an impossible grid solution (i.e. no more solution for another unsetted cell)
+
+			for (size_t ii = 0; (ii < mMaxAllowedValue) && allowed; ii++) {
+				if ((ii != i) && (mAllowedValuesMap[ii][j] == value_bit)) {
+					allowed = false;
+					ret = ERR_UNABLE_TO_FILL_HINTS;
+				}
+			}
+
+			for (size_t jj = 0; (jj < mMaxAllowedValue) && allowed; jj++) {
+				if ((jj != j) && (mAllowedValuesMap[i][jj] == value_bit)) {
+					allowed = false;
+					ret = ERR_UNABLE_TO_FILL_HINTS;
+				}
+			}
+
+			size_t i_min = (i / mGridRootSize) * mGridRootSize;
+			size_t j_min = (j / mGridRootSize) * mGridRootSize;
+
+			for (size_t jj = j_min; (jj < j_min + mGridRootSize) && allowed; jj++) {
+				for (size_t ii = i_min; (ii < i_min + mGridRootSize) && allowed; ii++) {
+					if (((ii != i) && (jj != j)) && (mAllowedValuesMap[ii][jj] == value_bit)) {
+						allowed = false;
+						ret = ERR_UNABLE_TO_FILL_HINTS;
+					}
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::checkColumn(size_t I, bool& complete) const {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		complete = true;
+
+		if ((I <= mMaxAllowedValue) && (I >= mMinAllowedValue)) {
+			for (size_t j = 0; j < mMaxAllowedValue; j++) {
+				if (VOID_VALUE == mInternalGrid[I - 1][j]) {
+					complete = false;
+				}
+			}
+		} else {
+			ret = ERR_OUT_OF_GRIDS_BOUNDS;
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::checkRow(size_t J, bool& complete) const {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		complete = true;
+
+		if ((J <= mMaxAllowedValue) && (J >= mMinAllowedValue)) {
+			for (size_t i = 0; i < mMaxAllowedValue; i++) {
+				if (VOID_VALUE == mInternalGrid[i][J - 1]) {
+					complete = false;
+				}
+			}
+		}
+		else {
+			ret = ERR_OUT_OF_GRIDS_BOUNDS;
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::checkBlock(size_t K, bool& complete) const {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+		complete = true;
+
+		size_t I_min = 0;
+		size_t I_max = 0;
+		size_t J_min = 0;
+		size_t J_max = 0;
+
+		if ((K <= mMaxAllowedValue) && (K >= mMinAllowedValue)) {
+
+			this->getBlockBounds(K, I_min, I_max, J_min, J_max);
+
+			for (size_t J = J_min; J <= J_max; J++) {
+				for (size_t I = I_min; I <= I_max; I++) {
+					if (VOID_VALUE == mInternalGrid[I - 1][J - 1]) {
+						complete = false;
+					}
+				}
+			}
+		}
+		else {
+			ret = ERR_OUT_OF_GRIDS_BOUNDS;
+		}
+
+		return ret;
+	}
+
+	bool RegulareSquare::isGridCompleted() const {
+		return mFilledCellsCount == (mMaxAllowedValue * mMaxAllowedValue);
+	}
+
+	size_t RegulareSquare::filledCellsCount() const {
+		return mFilledCellsCount;
+	}
+
+	bool RegulareSquare::isInGridBounds(size_t i, size_t j) const {
+		return (i <= mMaxAllowedValue) && (i >= mMinAllowedValue) && (j <= mMaxAllowedValue) && (j >= mMinAllowedValue);
+	}
+
+	bool RegulareSquare::isInValuesBounds(size_t value) const {
+		return (value <= mMaxAllowedValue) && (value >= mMinAllowedValue);
+	}
+
+	std::string RegulareSquare::toLine() const {
+		std::string line;
+		line.reserve(mMaxAllowedValue * mMaxAllowedValue);
+
+		// Row by row, '.' for a void cell, then the digit of the value
+		for (size_t j = 0; j < mMaxAllowedValue; j++) {
+			for (size_t i = 0; i < mMaxAllowedValue; i++) {
+				const size_t V = mInternalGrid[i][j];
+				line.push_back((VOID_VALUE == V) ? '.' : LINE_DIGITS[V - 1]);
+			}
+		}
+
+		return line;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::fromLine(const char* line, size_t length) {
+
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		if (length != mMaxAllowedValue * mMaxAllowedValue) {
+			return ERR_OUT_OF_GRIDS_BOUNDS;
+		}
+
+		this->resetInternalGrids();
+		mSolved = false;
+		mSolutions.clear();
+
+		// Up to 35 values, the letters are the same in both cases
+		const bool fold_case = (mMaxAllowedValue <= 35);
+
+		for (size_t k = 0; (k < length) && (ret == ERR_OK); k++) {
+			char c = line[k];
+			if ((c == '.') || (c == '0')) {
+				continue;
+			}
+			if (fold_case && (c >= 'a') && (c <= 'z')) {
+				c = static_cast<char>(c - 'a' + 'A');
+			}
+
+			const char* digit = (c != '\0') ? strchr(LINE_DIGITS, c) : nullptr;
+			if (digit == nullptr) {
+				ret = ERR_OUT_OF_VALUES_BOUNDS;
+				break;
+			}
+			const size_t V = static_cast<size_t>(digit - LINE_DIGITS) + 1;
+
+			// Row by row : same order as toLine
+			ret = this->setValue(k % mMaxAllowedValue + 1, k / mMaxAllowedValue + 1, V);
+		}
+
+		return ret;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::fromValues(const GridCell* values) {
+
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		this->resetInternalGrids();
+		mSolved = false;
+		mSolutions.clear();
+
+		for (size_t k = 0; (k < mMaxAllowedValue * mMaxAllowedValue) && (ret == ERR_OK); k++) {
+			if (VOID_VALUE != values[k]) {
+				ret = this->setValue(k / mMaxAllowedValue + 1, k % mMaxAllowedValue + 1, values[k]);
+			}
+		}
+
+		return ret;
+	}
+
+	size_t RegulareSquare::rootSizeOfLine(size_t length) {
+		for (size_t root = MIN_GRID_ROOT_SIZE; root <= MAX_GRID_ROOT_SIZE; root++) {
+			if (root * root * root * root == length) {
+				return root;
+			}
+		}
+		return 0;
+	}
+
+	void RegulareSquare::dump() const {
+		this->dumpValues(mInternalGrid.data());
+	}
+
+	void RegulareSquare::dumpValues(const GridCell* values) const {
+
+		for (size_t j = 0; j < mMaxAllowedValue; j++) {
+			for (size_t i = 0; i < mMaxAllowedValue; i++) {
+				const size_t V = values[i * mMaxAllowedValue + j];
+				if (VOID_VALUE != V) {
+					std::cout << " " << V;
+				} else {
+					std::cout << " " << "-";
+				}
+			}
+			std::cout << std::endl;
+		}
+
+	}
+
+	void RegulareSquare::dumpSolutions() const {
+		for (size_t s = 0; s < mSolutions.size(); s++) {
+			std::cout << "-------------------------------- Solution #" << (s + 1) << std::endl;
+			this->dumpValues(mSolutions[s]);
+		}
+	}
+
+	void RegulareSquare::dumpAllowedValuesNumbers() const {
+		for (size_t j = 0; j < mMaxAllowedValue; j++) {
+			for (size_t i = 0; i < mMaxAllowedValue; i++) {
+				std::cout << " " << countValues(mAllowedValuesMap[i][j]);
+			}
+			std::cout << std::endl;
+		}
+	}
+
+	void RegulareSquare::dumpStatistics() const {
+		std::cout << "Searches       : " << mStatistics.SearchesNumber << std::endl;
+		std::cout << "Nodes          : " << mStatistics.NodesNumber << std::endl;
+		std::cout << "Backtracks     : " << mStatistics.BacktracksNumber << std::endl;
+		std::cout << "Max depth      : " << mStatistics.MaxDepth << std::endl;
+		std::cout << "Grid copies    : " << mStatistics.GridCopiesNumber << std::endl;
+		std::cout << "Clue removals  : " << mStatistics.ClueRemovalsNumber << std::endl;
+		std::cout << "Route restarts : " << mStatistics.RouteRestartsNumber << std::endl;
+		std::cout << "Cache hits     : " << mStatistics.CacheHitsNumber << " (" << mStatistics.CacheMissesNumber << " misses)" << std::endl;
+		for (size_t t = 0; t < PROPAGATION_TECHNIQUES_NUMBER; t++) {
+			std::cout << "Eliminations " << propagationTechniqueName(t) << " : " << mStatistics.Eliminations[t] << std::endl;
+		}
+		std::cout << "Fill time (s)         : " << mStatistics.FillSeconds << std::endl;
+		std::cout << "Minimization time (s) : " << mStatistics.MinimizationSeconds << std::endl;
+		std::cout << "Search time (s)       : " << mStatistics.SearchSeconds << std::endl;
+		std::cout << "Propagation time (s)  : " << mStatistics.PropagationSeconds << std::endl;
+	}
+
+	void RegulareSquare::resetStatistics() {
+		mStatistics = SolveStatistics();
+	}
+
+	void RegulareSquare::addStatistics(const SolveStatistics& statistics) {
+		mStatistics.NodesNumber += statistics.NodesNumber;
+		mStatistics.BacktracksNumber += statistics.BacktracksNumber;
+		if (statistics.MaxDepth > mStatistics.MaxDepth) {
+			mStatistics.MaxDepth = statistics.MaxDepth;
+		}
+		mStatistics.SearchesNumber += statistics.SearchesNumber;
+		mStatistics.GridCopiesNumber += statistics.GridCopiesNumber;
+		mStatistics.RouteRestartsNumber += statistics.RouteRestartsNumber;
+		mStatistics.ClueRemovalsNumber += statistics.ClueRemovalsNumber;
+		mStatistics.CacheHitsNumber += statistics.CacheHitsNumber;
+		mStatistics.CacheMissesNumber += statistics.CacheMissesNumber;
+		for (size_t t = 0; t < PROPAGATION_TECHNIQUES_NUMBER; t++) {
+			mStatistics.Eliminations[t] += statistics.Eliminations[t];
+		}
+		mStatistics.FillSeconds += statistics.FillSeconds;
+		mStatistics.MinimizationSeconds += statistics.MinimizationSeconds;
+		mStatistics.SearchSeconds += statistics.SearchSeconds;
+		mStatistics.PropagationSeconds += statistics.PropagationSeconds;
+	}
+
+	const char* RegulareSquare::propagationTechniqueName(size_t technique_index) {
+		static const char* names[PROPAGATION_TECHNIQUES_NUMBER] = { "naked singles", "hidden singles", "naked pairs", "hidden pairs", "pointing", "x-wing" };
+		return (technique_index < PROPAGATION_TECHNIQUES_NUMBER) ? names[technique_index] : "unknown";
+	}
+
+	void RegulareSquare::resetInternalGrids() {
+		mInternalGrid.fill(VOID_VALUE);
+		mAllowedValuesMap.fill(fullMask(mMaxAllowedValue));
+		for (size_t k = 0; k < mMaxAllowedValue; k++) {
+			mRowsMask[k] = 0;
+			mColumnsMask[k] = 0;
+			mBlocksMask[k] = 0;
+		}
+		mFilledCellsCount = 0;
+		mGridHash = 0;
+	}
+
+	void RegulareSquare::setInternalGrid(const InternalGrid& grid) {
+		for (size_t I = 1; I <= mMaxAllowedValue; I++) {
+			for (size_t J = 1; J <= mMaxAllowedValue; J++) {
+				this->setValue(I,J,grid[I-1][J-1]);
+			}
+		}
+	}
+
+	void RegulareSquare::exportValues(std::vector<size_t>& values) const {
+		values.resize(mMaxAllowedValue * mMaxAllowedValue);
+		for (size_t i = 0; i < mMaxAllowedValue; i++) {
+			for (size_t j = 0; j < mMaxAllowedValue; j++) {
+				values[i * mMaxAllowedValue + j] = mInternalGrid[i][j];
+			}
+		}
+	}
+
+	void RegulareSquare::loadValues(const std::vector<size_t>& values) {
+		this->resetInternalGrids();
+		for (size_t i = 0; i < mMaxAllowedValue; i++) {
+			for (size_t j = 0; j < mMaxAllowedValue; j++) {
+				if (VOID_VALUE != values[i * mMaxAllowedValue + j]) {
+					this->placeValue(i, j, values[i * mMaxAllowedValue + j], nullptr);
+				}
+			}
+		}
+		mSolved = false;
+		mSolutions.clear();
+	}
+
+	void RegulareSquare::shuffle(std::vector<size_t>& values) const {
+		// Fisher-Yates
+		for (size_t k = values.size(); k > 1; k--) {
+			std::swap(values[k - 1], values[this->randomIndex(k)]);
+		}
+	}
+
+	void RegulareSquare::randomLinesOrder(std::vector<size_t>& lines) const {
+		std::vector<size_t> bands(mGridRootSize);
+		std::vector<size_t> band_lines(mGridRootSize);
+
+		for (size_t b = 0; b < mGridRootSize; b++) {
+			bands[b] = b;
+		}
+		this->shuffle(bands);
+
+		lines.resize(mMaxAllowedValue);
+		for (size_t b = 0; b < mGridRootSize; b++) {
+			for (size_t k = 0; k < mGridRootSize; k++) {
+				band_lines[k] = k;
+			}
+			this->shuffle(band_lines);
+			for (size_t k = 0; k < mGridRootSize; k++) {
+				lines[b * mGridRootSize + k] = bands[b] * mGridRootSize + band_lines[k];
+			}
+		}
+	}
+
+	void RegulareSquare::fillFromPattern() {
+		std::vector<size_t> relabel(mMaxAllowedValue);
+		std::vector<size_t> rows;
+		std::vector<size_t> columns;
+		std::vector<size_t> values(mMaxAllowedValue * mMaxAllowedValue);
+
+		for (size_t V = 1; V <= mMaxAllowedValue; V++) {
+			relabel[V - 1] = V;
+		}
+		this->shuffle(relabel);
+		this->randomLinesOrder(rows);
+		this->randomLinesOrder(columns);
+		const bool transpose = (this->randomIndex(2) == 1);
+
+		for (size_t i = 0; i < mMaxAllowedValue; i++) {
+			for (size_t j = 0; j < mMaxAllowedValue; j++) {
+				size_t r = rows[j];
+				size_t c = columns[i];
+				if (transpose) {
+					std::swap(r, c);
+				}
+				// Base pattern : each row is the previous one shifted by root (by root + 1 at each band change)
+				const size_t base_value = (mGridRootSize * (r % mGridRootSize) + r / mGridRootSize + c) % mMaxAllowedValue;
+				values[i * mMaxAllowedValue + j] = relabel[base_value];
+			}
+		}
+
+		this->loadValues(values);
+	}
+
+	void RegulareSquare::placeValue(size_t i, size_t j, size_t V, SearchTrail* trail) {
+		const ValueMask value_bit = valueBit(V);
+
+		if (trail != nullptr) {
+			trail->push_back({ i * mMaxAllowedValue + j, V, mAllowedValuesMap[i][j] });
+		}
+
+		mInternalGrid[i][j] = static_cast<GridCell>(V);
+		mFilledCellsCount++;
+		mGridHash ^= cellKey(i * mMaxAllowedValue + j, V);
+
+		// Mark the value as used in the row, column and block
+		mRowsMask[j] |= value_bit;
+		mColumnsMask[i] |= value_bit;
+		mBlocksMask[this->blockIndex(i, j)] |= value_bit;
+
+		// on supprime toutes les possibilités pour la case
+		mAllowedValuesMap[i][j] = 0;
+
+		// Update allowed values for row
+		for (size_t ii = 0; ii < mMaxAllowedValue; ii++) {
+			this->removeCandidates(ii, j, value_bit, trail);
+		}
+		// Update allowed values for column
+		for (size_t jj = 0; jj < mMaxAllowedValue; jj++) {
+			this->removeCandidates(i, jj, value_bit, trail);
+		}
+		// Update allowed values for block
+		size_t i_min = (i / mGridRootSize) * mGridRootSize;
+		size_t j_min = (j / mGridRootSize) * mGridRootSize;
+
+		for (size_t jj = j_min; jj < j_min + mGridRootSize; jj++) {
+			for (size_t ii = i_min; ii < i_min + mGridRootSize; ii++) {
+				this->removeCandidates(ii, jj, value_bit, trail);
+			}
+		}
+	}
+
+	bool RegulareSquare::removeCandidates(size_t i, size_t j, ValueMask mask, SearchTrail* trail) {
+		const ValueMask removed = mAllowedValuesMap[i][j] & mask;
+		if (removed != 0) {
+			mAllowedValuesMap[i][j] &= ~removed;
+			if (trail != nullptr) {
+				trail->push_back({ i * mMaxAllowedValue + j, VOID_VALUE, removed });
+			}
+		}
+		return removed != 0;
+	}
+
+	void RegulareSquare::restoreCandidate(size_t i, size_t j, ValueMask value_bit) {
+		const ValueMask used_values = mRowsMask[j] | mColumnsMask[i] | mBlocksMask[this->blockIndex(i, j)];
+		if ((mInternalGrid[i][j] == VOID_VALUE) && ((used_values & value_bit) == 0)) {
+			mAllowedValuesMap[i][j] |= value_bit;
+		}
+	}
+
+	void RegulareSquare::rewindTrail(SearchTrail& trail, size_t mark) {
+		while (trail.size() > mark) {
+			const TrailEntry& entry = trail.back();
+			const size_t i = entry.Cell / mMaxAllowedValue;
+			const size_t j = entry.Cell % mMaxAllowedValue;
+
+			mAllowedValuesMap[i][j] |= entry.Removed;
+
+			if (entry.Value != VOID_VALUE) {
+				const ValueMask value_bit = valueBit(entry.Value);
+				mInternalGrid[i][j] = VOID_VALUE;
+				mFilledCellsCount--;
+				mGridHash ^= cellKey(entry.Cell, entry.Value);
+				mRowsMask[j] &= ~value_bit;
+				mColumnsMask[i] &= ~value_bit;
+				mBlocksMask[this->blockIndex(i, j)] &= ~value_bit;
+			}
+
+			trail.pop_back();
+		}
+	}
+
+	void RegulareSquare::unitCell(size_t u, size_t k, size_t& i, size_t& j) const {
+		if (u < mMaxAllowedValue) {
+			// Row J = u + 1
+			i = k;
+			j = u;
+		} else if (u < 2 * mMaxAllowedValue) {
+			// Column I = u - N + 1
+			i = u - mMaxAllowedValue;
+			j = k;
+		} else {
+			// Block K = u - 2N + 1
+			const size_t b = u - 2 * mMaxAllowedValue;
+			i = (b % mGridRootSize) * mGridRootSize + k % mGridRootSize;
+			j = (b / mGridRootSize) * mGridRootSize + k / mGridRootSize;
+		}
+	}
+
+	ValueMask RegulareSquare::unitValues(size_t u) const {
+		if (u < mMaxAllowedValue) {
+			return mRowsMask[u];
+		} else if (u < 2 * mMaxAllowedValue) {
+			return mColumnsMask[u - mMaxAllowedValue];
+		}
+		return mBlocksMask[u - 2 * mMaxAllowedValue];
+	}
+
+	bool RegulareSquare::propagate(SearchTrail* trail, SolveStatistics* statistics) {
+		bool consistent = true;
+		size_t changes = 1;
+
+		std::chrono::steady_clock::time_point start;
+		if (statistics != nullptr) {
+			start = std::chrono::steady_clock::now();
+		}
+
+		// Cheapest techniques first, and back to them as soon as one of the others changed the grid
+		while (consistent && (changes > 0)) {
+			changes = 0;
+
+			// The last technique applied is the one which changed the grid (if any)
+			size_t technique_index = 0;
+			if (consistent && (changes == 0) && (mPropagationTechniques & PROPAGATE_NAKED_SINGLES)) {
+				technique_index = 0;
+				consistent = this->applyNakedSingles(trail, changes);
+			}
+			if (consistent && (changes == 0) && (mPropagationTechniques & PROPAGATE_HIDDEN_SINGLES)) {
+				technique_index = 1;
+				consistent = this->applyHiddenSingles(trail, changes);
+			}
+			if (consistent && (changes == 0) && (mPropagationTechniques & PROPAGATE_POINTING)) {
+				technique_index = 4;
+				consistent = this->applyPointing(trail, changes);
+			}
+			if (consistent && (changes == 0) && (mPropagationTechniques & PROPAGATE_NAKED_PAIRS)) {
+				technique_index = 2;
+				consistent = this->applyNakedPairs(trail, changes);
+			}
+			if (consistent && (changes == 0) && (mPropagationTechniques & PROPAGATE_HIDDEN_PAIRS)) {
+				technique_index = 3;
+				consistent = this->applyHiddenPairs(trail, changes);
+			}
+			if (consistent && (changes == 0) && (mPropagationTechniques & PROPAGATE_X_WING)) {
+				technique_index = 5;
+				consistent = this->applyXWing(trail, changes);
+			}
+
+			if (statistics != nullptr) {
+				statistics->Eliminations[technique_index] += changes;
+			}
+		}
+
+		if (statistics != nullptr) {
+			statistics->PropagationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		return consistent;
+	}
+
+	bool RegulareSquare::applyNakedSingles(SearchTrail* trail, size_t& changes) {
+		bool consistent = true;
+		const CandidateKernels& kernels = candidateKernels();
+		const size_t cells_number = mMaxAllowedValue * mMaxAllowedValue;
+
+		// The kernel skips the cells with several candidates, the masks are read again after each placement
+		for (size_t k = kernels.FindSingleCell(mAllowedValuesMap.data(), mInternalGrid.data(), 0, cells_number);
+			 (k < cells_number) && consistent;
+			 k = kernels.FindSingleCell(mAllowedValuesMap.data(), mInternalGrid.data(), k + 1, cells_number)) {
+			const size_t i = k / mMaxAllowedValue;
+			const size_t j = k % mMaxAllowedValue;
+			const ValueMask values = mAllowedValuesMap[i][j];
+			if (values == 0) {
+				// Empty cell without any candidate left
+				consistent = false;
+			} else {
+				this->placeValue(i, j, lowestValue(values), trail);
+				changes++;
+			}
+		}
+
+		return consistent;
+	}
+
+	bool RegulareSquare::applyHiddenSingles(SearchTrail* trail, size_t& changes) {
+		bool consistent = true;
+		const ValueMask all_values = fullMask(mMaxAllowedValue);
+		const CandidateKernels& kernels = candidateKernels();
+
+		// Values seen in at least one / two cells of each unit, computed again after a placement
+		ValueMask seen_once[3 * MAX_MASK_VALUES];
+		ValueMask seen_twice[3 * MAX_MASK_VALUES];
+		bool      seen_values_changed = true;
+
+		for (size_t u = 0; (u < 3 * mMaxAllowedValue) && consistent; u++) {
+			size_t i = 0;
+			size_t j = 0;
+
+			if (seen_values_changed) {
+				kernels.UnitsSeenValues(mAllowedValuesMap.data(), mGridRootSize, seen_once, seen_twice);
+				seen_values_changed = false;
+			}
+
+			if ((seen_once[u] | this->unitValues(u)) != all_values) {
+				// A value can't be set anywhere in the unit
+				consistent = false;
+			} else {
+				ValueMask singles = seen_once[u] & ~seen_twice[u];
+				seen_values_changed = (singles != 0);
+				while ((singles != 0) && consistent) {
+					const size_t V = lowestValue(singles);
+					singles = clearLowestValue(singles);
+
+					// Its cell may have been taken by another single of the unit meanwhile
+					consistent = false;
+					for (size_t k = 0; (k < mMaxAllowedValue) && !consistent; k++) {
+						this->unitCell(u, k, i, j);
+						if (hasValue(mAllowedValuesMap[i][j], V)) {
+							this->placeValue(i, j, V, trail);
+							changes++;
+							consistent = true;
+						}
+					}
+				}
+			}
+		}
+
+		return consistent;
+	}
+
+	bool RegulareSquare::applyNakedPairs(SearchTrail* trail, size_t& changes) {
+		for (size_t u = 0; u < 3 * mMaxAllowedValue; u++) {
+			size_t i = 0;
+			size_t j = 0;
+			for (size_t a = 0; a < mMaxAllowedValue; a++) {
+				this->unitCell(u, a, i, j);
+				const ValueMask pair = mAllowedValuesMap[i][j];
+				if (countValues(pair) == 2) {
+					for (size_t b = a + 1; b < mMaxAllowedValue; b++) {
+						this->unitCell(u, b, i, j);
+						if (mAllowedValuesMap[i][j] == pair) {
+							// The two values are bound to these two cells : remove them from the rest of the unit
+							for (size_t k = 0; k < mMaxAllowedValue; k++) {
+								if ((k != a) && (k != b)) {
+									this->unitCell(u, k, i, j);
+									if (this->removeCandidates(i, j, pair, trail)) {
+										changes++;
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Cells emptied by the eliminations are reported by the singles or the search
+		return true;
+	}
+
+	bool RegulareSquare::applyHiddenPairs(SearchTrail* trail, size_t& changes) {
+		ValueMask positions[MAX_MASK_VALUES];
+
+		for (size_t u = 0; u < 3 * mMaxAllowedValue; u++) {
+			size_t i = 0;
+			size_t j = 0;
+
+			// Positions (bit k for the cell k of the unit) of each value
+			for (size_t V = 1; V <= mMaxAllowedValue; V++) {
+				positions[V - 1] = 0;
+			}
+			for (size_t k = 0; k < mMaxAllowedValue; k++) {
+				this->unitCell(u, k, i, j);
+				for (ValueMask values = mAllowedValuesMap[i][j]; values != 0; values = clearLowestValue(values)) {
+					positions[lowestValue(values) - 1] |= ValueMask(1) << k;
+				}
+			}
+
+			for (size_t V1 = 1; V1 <= mMaxAllowedValue; V1++) {
+				if (countValues(positions[V1 - 1]) == 2) {
+					for (size_t V2 = V1 + 1; V2 <= mMaxAllowedValue; V2++) {
+						if (positions[V2 - 1] == positions[V1 - 1]) {
+							// The two cells can only hold these two values
+							const ValueMask others = ~(valueBit(V1) | valueBit(V2));
+							for (ValueMask cells = positions[V1 - 1]; cells != 0; cells = clearLowestValue(cells)) {
+								this->unitCell(u, lowestValue(cells) - 1, i, j);
+								if (this->removeCandidates(i, j, others, trail)) {
+									changes++;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool RegulareSquare::applyPointing(SearchTrail* trail, size_t& changes) {
+		for (size_t u = 0; u < 3 * mMaxAllowedValue; u++) {
+			const bool is_block = (u >= 2 * mMaxAllowedValue);
+			const ValueMask missing_values = fullMask(mMaxAllowedValue) & ~this->unitValues(u);
+
+			for (ValueMask values = missing_values; values != 0; values = clearLowestValue(values)) {
+				const size_t V = lowestValue(values);
+				const ValueMask value_bit = valueBit(V);
+				size_t i = 0;
+				size_t j = 0;
+
+				// Look if all the positions of the value share a row / column (block) or a block (line)
+				bool first = true;
+				bool same_i = true;
+				bool same_j = true;
+				bool same_block = true;
+				size_t first_i = 0;
+				size_t first_j = 0;
+				for (size_t k = 0; k < mMaxAllowedValue; k++) {
+					this->unitCell(u, k, i, j);
+					if (mAllowedValuesMap[i][j] & value_bit) {
+						if (first) {
+							first = false;
+							first_i = i;
+							first_j = j;
+						} else {
+							same_i = same_i && (i == first_i);
+							same_j = same_j && (j == first_j);
+							same_block = same_block && (this->blockIndex(i, j) == this->blockIndex(first_i, first_j));
+						}
+					}
+				}
+
+				if (first) {
+					// No position at all : reported by the hidden singles or the search
+					continue;
+				}
+
+				if (is_block) {
+					// Pointing : the value of the block is on a single row / column, remove it from the rest of the line
+					const size_t block = u - 2 * mMaxAllowedValue;
+					for (size_t k = 0; k < mMaxAllowedValue; k++) {
+						if (same_j && (this->blockIndex(k, first_j) != block) && this->removeCandidates(k, first_j, value_bit, trail)) {
+							changes++;
+						}
+						if (same_i && (this->blockIndex(first_i, k) != block) && this->removeCandidates(first_i, k, value_bit, trail)) {
+							changes++;
+						}
+					}
+				} else if (same_block) {
+					// Claiming : the value of the line is in a single block, remove it from the rest of the block
+					const size_t block_unit = 2 * mMaxAllowedValue + this->blockIndex(first_i, first_j);
+					for (size_t k = 0; k < mMaxAllowedValue; k++) {
+						this->unitCell(block_unit, k, i, j);
+						const bool in_line = (u < mMaxAllowedValue) ? (j == first_j) : (i == first_i);
+						if (!in_line && this->removeCandidates(i, j, value_bit, trail)) {
+							changes++;
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool RegulareSquare::applyXWing(SearchTrail* trail, size_t& changes) {
+		// Positions of the value in each line, as a mask of the cells indexes along the line
+		ValueMask positions[MAX_MASK_VALUES];
+
+		for (size_t V = mMinAllowedValue; V <= mMaxAllowedValue; V++) {
+			const ValueMask value_bit = valueBit(V);
+
+			// Lines with j fixed (rows) first, then with i fixed (columns)
+			for (size_t by_rows = 0; by_rows < 2; by_rows++) {
+				for (size_t a = 0; a < mMaxAllowedValue; a++) {
+					positions[a] = 0;
+					for (size_t b = 0; b < mMaxAllowedValue; b++) {
+						const ValueMask values = by_rows ? mAllowedValuesMap[b][a] : mAllowedValuesMap[a][b];
+						if (values & value_bit) {
+							positions[a] |= ValueMask(1) << b;
+						}
+					}
+				}
+
+				// Two lines with the value on the same two positions : it is on one of them in each line,
+				// so the value can be removed from these two positions in all the other lines
+				for (size_t a1 = 0; a1 < mMaxAllowedValue; a1++) {
+					if (countValues(positions[a1]) != 2) {
+						continue;
+					}
+					for (size_t a2 = a1 + 1; a2 < mMaxAllowedValue; a2++) {
+						if (positions[a2] != positions[a1]) {
+							continue;
+						}
+						for (ValueMask cells = positions[a1]; cells != 0; cells = clearLowestValue(cells)) {
+							const size_t b = lowestValue(cells) - 1;
+							for (size_t a = 0; a < mMaxAllowedValue; a++) {
+								if ((a != a1) && (a != a2) &&
+									this->removeCandidates(by_rows ? b : a, by_rows ? a : b, value_bit, trail)) {
+									changes++;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool RegulareSquare::applyTechnique(size_t technique_index, SearchTrail* trail, size_t& changes) {
+		switch (technique_index) {
+		case 0:
+			return this->applyNakedSingles(trail, changes);
+		case 1:
+			return this->applyHiddenSingles(trail, changes);
+		case 2:
+			return this->applyNakedPairs(trail, changes);
+		case 3:
+			return this->applyHiddenPairs(trail, changes);
+		case 4:
+			return this->applyPointing(trail, changes);
+		case 5:
+			return this->applyXWing(trail, changes);
+		default:
+			return true;
+		}
+	}
+
+	namespace {
+
+		// Techniques indexes from the easiest to the hardest for a human solver
+		const size_t GRADING_ORDER[RegulareSquare::PROPAGATION_TECHNIQUES_NUMBER] = { 1, 0, 4, 2, 3, 5 };
+
+		// By technique index, for each cell set or candidate removed
+		const size_t TECHNIQUE_WEIGHTS[RegulareSquare::PROPAGATION_TECHNIQUES_NUMBER] = { 2, 1, 10, 15, 5, 20 };
+		const RegulareSquare::DIFFICULTY_LEVEL TECHNIQUE_LEVELS[RegulareSquare::PROPAGATION_TECHNIQUES_NUMBER] = {
+			RegulareSquare::DIFFICULTY_EASY, RegulareSquare::DIFFICULTY_EASY, RegulareSquare::DIFFICULTY_MEDIUM,
+			RegulareSquare::DIFFICULTY_HARD, RegulareSquare::DIFFICULTY_MEDIUM, RegulareSquare::DIFFICULTY_HARD };
+
+		// For each cell set from the solution
+		const size_t GUESS_WEIGHT = 50;
+
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::gradeDifficulty(DifficultyRating& rating) const {
+		rating = DifficultyRating();
+		rating.Level = DIFFICULTY_EASY;
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		// The guesses take their value from the solution
+		RegulareSquare solver = *this;
+		solver.mSolutions.clear();
+		solver.mSearchNodesNumber = 0;
+		const size_t solutions_number = solver.runSearch(2, true);
+		if (solutions_number == 0) {
+			return ERR_NO_MORE_HYPOTHESIS;
+		} else if (solutions_number > 1) {
+			return ERR_MULTIPLE_SOLUTIONS;
+		}
+		return this->gradeDifficulty(rating, solver.mSolutions[0]);
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::gradeDifficulty(DifficultyRating& rating, const GridCell* solution) const {
+		rating = DifficultyRating();
+		rating.Level = DIFFICULTY_EASY;
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		// One step : the easiest technique changing the grid, and back to the easiest ones
+		SearchTrail unused_trail;
+		ScratchLease scratch(*this, unused_trail);
+		RegulareSquare& grid = scratch.grid();
+		while (grid.filledCellsCount() < mMaxAllowedValue * mMaxAllowedValue) {
+			bool progress = false;
+
+			for (size_t t = 0; (t < PROPAGATION_TECHNIQUES_NUMBER) && !progress; t++) {
+				const size_t technique_index = GRADING_ORDER[t];
+				size_t changes = 0;
+				if (!grid.applyTechnique(technique_index, nullptr, changes)) {
+					// Only wrong values lead to a contradiction
+					return ERR_NO_MORE_HYPOTHESIS;
+				}
+				if (changes > 0) {
+					rating.Steps[technique_index]++;
+					rating.Changes[technique_index] += changes;
+					rating.Score += TECHNIQUE_WEIGHTS[technique_index] * changes;
+					if (TECHNIQUE_LEVELS[technique_index] > rating.Level) {
+						rating.Level = TECHNIQUE_LEVELS[technique_index];
+					}
+					progress = true;
+				}
+			}
+
+			if (!progress) {
+				// Stuck : set the most constrained cell from the solution, as a lucky guess would
+				size_t i = 0;
+				size_t j = 0;
+				grid.selectMostConstrainedCell(i, j);
+				grid.placeValue(i, j, solution[i * mMaxAllowedValue + j], nullptr);
+
+				rating.GuessesNumber++;
+				rating.Score += GUESS_WEIGHT;
+				rating.Level = DIFFICULTY_EXPERT;
+			}
+		}
+
+		return ERR_OK;
+	}
+
+	RegulareSquare::DIFFICULTY_LEVEL RegulareSquare::difficultyLevel(const GridCell* solution) const {
+		DifficultyRating rating;
+		return (this->gradeDifficulty(rating, solution) == ERR_OK) ? rating.Level : DIFFICULTY_EXPERT;
+	}
+
+	const char* RegulareSquare::difficultyLevelName(DIFFICULTY_LEVEL level) {
+		static const char* names[] = { "easy", "medium", "hard", "expert" };
+		return (level <= DIFFICULTY_EXPERT) ? names[level] : "unknown";
+	}
+
+	void RegulareSquare::buildHypothesisMap(OrderedHypothesisMap& hypothesis_map, bool scrambled) const {
+		hypothesis_map.clear();
+		for (size_t j = 0; j < this->mMaxAllowedValue; j++) {
+			for (size_t i = 0; i < this->mMaxAllowedValue; i++) {
+				const ValueMask cell_values = this->mAllowedValuesMap[i][j];
+				if (cell_values != 0) {
+					CellHypothesis hypothesis;
+					hypothesis.I = i + 1;
+					hypothesis.J = j + 1;
+					hypothesis.Values = cell_values;
+
+					// Build the ordered hypothesis (the lower number of possible values first)
+					if (!scrambled) {
+						hypothesis.Weight = countValues(cell_values);
+					} else {
+						hypothesis.Weight = this->randomIndex(mMaxAllowedValue * mMaxAllowedValue);
+					}
+					hypothesis_map.push_back(hypothesis);
+				}
+			}
+		}
+
+		std::stable_sort(hypothesis_map.begin(), hypothesis_map.end(), [](const CellHypothesis& a, const CellHypothesis& b) {
+			return a.Weight < b.Weight;
+		});
+	}
+
+	size_t RegulareSquare::runSearch(size_t solutions_limit, bool store_solutions, const SolutionVisitor* visitor, size_t nodes_limit) {
+
+		if (!this->isValid()) {
+			return 0;
+		}
+
+		SearchContext context;
+		context.SolutionsLimit = solutions_limit;
+		context.SolutionsNumber = 0;
+		context.StoreSolutions = store_solutions;
+		context.Cancel = nullptr;
+		context.NodesLimit = nodes_limit;
+		context.RandomizeValues = false;
+		context.Visitor = visitor;
+		context.Statistics = this->statistics();
+		context.Depth = 0;
+
+		auto start = std::chrono::steady_clock::now();
+
+		if (mSolverBackend == SOLVER_DANCING_LINKS) {
+			this->solveExactCover(context);
+			if (context.Statistics != nullptr) {
+				context.Statistics->NodesNumber += mSearchNodesNumber;
+			}
+		} else {
+			// Copy the grid in the scratch of the thread : the search works in place on this copy and
+			// undoes its hypothesis through the trail instead of copying the grid at each level
+			ScratchLease scratch(*this, context.Trail);
+			RegulareSquare& grid = scratch.grid();
+			if (context.Statistics != nullptr) {
+				context.Statistics->GridCopiesNumber++;
+			}
+
+			if (grid.propagate(&context.Trail, context.Statistics)) {
+				// Propagation of the initial values may already complete the grid :
+				// the search then only records the solution
+				if (mSearchStrategy == SEARCH_STATIC_ORDER) {
+					// build the hypothesis
+					// Order the remaining void cells
+					OrderedHypothesisMap& hypothesis_map = scratch.hypothesis();
+
+					grid.buildHypothesisMap(hypothesis_map);
+
+					this->recursiveSolve(grid, context, hypothesis_map, hypothesis_map.begin());
+				} else {
+					// The cells are picked while searching, no need for an hypothesis map
+					this->recursiveSolveMRV(grid, context);
+				}
+			}
+		}
+
+		if (context.Statistics != nullptr) {
+			context.Statistics->SearchesNumber++;
+			context.Statistics->SearchSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		return context.SolutionsNumber;
+	}
+
+	void RegulareSquare::recordSolution(const RegulareSquare& grid, SearchContext& context) {
+		context.SolutionsNumber++;
+		if (context.StoreSolutions) {
+			mSolved = true;
+			mSolutions.add(grid.mInternalGrid.data());
+		}
+		if ((context.Visitor != nullptr) && !(*context.Visitor)(grid.mInternalGrid.data())) {
+			// Stopped by the visitor : the search is over at this number of solutions
+			context.SolutionsLimit = context.SolutionsNumber;
+		}
+	}
+
+	bool RegulareSquare::recursiveSolve(RegulareSquare & grid,
+		                                SearchContext & context,
+		                                const OrderedHypothesisMap & hypothesis_map,
+		                                OrderedHypothesisMap::const_iterator next_hypothesis) {
+
+		bool solved = false;
+
+		// Skip the cells already filled by the propagation
+		while ((next_hypothesis != hypothesis_map.end()) &&
+			   (VOID_VALUE != grid.mInternalGrid[next_hypothesis->I - 1][next_hypothesis->J - 1])) {
+			next_hypothesis++;
+		}
+
+		if (next_hypothesis == hypothesis_map.end()) {
+			if (grid.isGridCompleted()) {
+				solved = true;
+				this->recordSolution(grid, context);
+			}
+			return solved;
+		}
+
+		const size_t i = next_hypothesis->I - 1;
+		const size_t j = next_hypothesis->J - 1;
+
+		OrderedHypothesisMap::const_iterator following_hypothesis = next_hypothesis;
+		following_hypothesis++;
+
+		ValueMask remaining_values = next_hypothesis->Values;
+
+		while (!this->isSearchOver(context) &&
+			   (remaining_values != 0)) {
+
+			const size_t V = lowestValue(remaining_values);
+			bool allowed = false;
+			grid.checkCandidate(i, j, V, allowed);
+
+			if (allowed) {
+				// Apply the hypothesis in place, remembering where to come back
+				const size_t trail_mark = context.Trail.size();
+				grid.placeValue(i, j, V, &context.Trail);
+				mSearchNodesNumber++;
+				context.Depth++;
+
+				const bool sub_solved = grid.propagate(&context.Trail, context.Statistics) &&
+										recursiveSolve(grid, context, hypothesis_map, following_hypothesis);
+				solved = sub_solved || solved;
+
+				countHypothesis(context, sub_solved);
+				context.Depth--;
+
+				// on réinitialise la grille à l'état précédent
+				grid.rewindTrail(context.Trail, trail_mark);
+			}
+
+			// on tente la valeur possible suivante pour cette case
+			remaining_values = clearLowestValue(remaining_values);
+		}
+
+		return solved;
+	}
+
+	void RegulareSquare::solveExactCover(SearchContext& context) {
+		std::vector<size_t> values;
+		this->exportValues(values);
+
+		DancingLinks exact_cover(mGridRootSize);
+
+		if (exact_cover.setGrid(values)) {
+			DancingLinks::SolutionVisitor store_solution;
+			if (context.StoreSolutions || (context.Visitor != nullptr)) {
+				std::vector<GridCell> packed_values(values.size());
+				store_solution = [this, &context, packed_values](const std::vector<size_t>& solution_values) mutable {
+					for (size_t k = 0; k < solution_values.size(); k++) {
+						packed_values[k] = static_cast<GridCell>(solution_values[k]);
+					}
+					if (context.StoreSolutions) {
+						mSolutions.add(packed_values.data());
+					}
+					return (context.Visitor == nullptr) || (*context.Visitor)(packed_values.data());
+				};
+			}
+			context.SolutionsNumber = exact_cover.search(context.SolutionsLimit, store_solution);
+			mSolved = !mSolutions.empty();
+		}
+
+		mSearchNodesNumber = exact_cover.getNodesNumber();
+	}
+
+	bool RegulareSquare::selectMostConstrainedCell(size_t& i, size_t& j) const {
+		bool found = false;
+		size_t best_count = mMaxAllowedValue + 1;
+		size_t best_degree = 0;
+
+		for (size_t ii = 0; (ii < mMaxAllowedValue) && (best_count > 1); ii++) {
+			for (size_t jj = 0; (jj < mMaxAllowedValue) && (best_count > 1); jj++) {
+				if (VOID_VALUE == mInternalGrid[ii][jj]) {
+					const size_t count = countValues(mAllowedValuesMap[ii][jj]);
+					if (count <= best_count) {
+						// Degree : number of empty cells in the row, column and block of the cell
+						size_t degree = 0;
+						if (mSearchStrategy == SEARCH_MRV_DEGREE) {
+							degree = 3 * mMaxAllowedValue
+								- countValues(mRowsMask[jj])
+								- countValues(mColumnsMask[ii])
+								- countValues(mBlocksMask[this->blockIndex(ii, jj)]);
+						}
+						if ((count < best_count) || (degree > best_degree)) {
+							found = true;
+							best_count = count;
+							best_degree = degree;
+							i = ii;
+							j = jj;
+						}
+					}
+				}
+			}
+		}
+
+		return found;
+	}
+
+	bool RegulareSquare::recursiveSolveMRV(RegulareSquare & grid,
+		                                   SearchContext & context) {
+
+		bool solved = false;
+		size_t i = 0;
+		size_t j = 0;
+
+		if (!grid.selectMostConstrainedCell(i, j)) {
+			// No more empty cell : the grid is a solution
+			solved = true;
+			this->recordSolution(grid, context);
+		} else {
+			ValueMask remaining_values = grid.mAllowedValuesMap[i][j];
+
+			// An empty cell without candidates is a dead end : the loop is skipped
+			while (!this->isSearchOver(context) && (remaining_values != 0)) {
+				ValueMask picked = remaining_values;
+				if (context.RandomizeValues) {
+					for (size_t skip = this->randomIndex(countValues(remaining_values)); skip > 0; skip--) {
+						picked = clearLowestValue(picked);
+					}
+				}
+				const size_t V = lowestValue(picked);
+				remaining_values &= ~valueBit(V);
+
+				bool allowed = false;
+				grid.checkCandidate(i, j, V, allowed);
+
+				if (allowed) {
+					// Apply the hypothesis in place, remembering where to come back
+					const size_t trail_mark = context.Trail.size();
+					grid.placeValue(i, j, V, &context.Trail);
+					mSearchNodesNumber++;
+					context.Depth++;
+
+					const bool sub_solved = grid.propagate(&context.Trail, context.Statistics) &&
+											recursiveSolveMRV(grid, context);
+					solved = sub_solved || solved;
+
+					countHypothesis(context, sub_solved);
+					context.Depth--;
+
+					grid.rewindTrail(context.Trail, trail_mark);
+				}
+			}
+		}
+
+		return solved;
+	}
+
+	RegulareSquare::ERROR_CODE RegulareSquare::getBlockBounds(size_t K, size_t& I_MIN, size_t& I_MAX, size_t& J_MIN, size_t& J_MAX) const {
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		size_t i_min = 0;
+		size_t i_max = 0;
+		size_t j_min = 0;
+		size_t j_max = 0;
+
+		if ((K <= mMaxAllowedValue) && (K >= mMinAllowedValue)) {
+
+			i_min = ((K - 1) * mGridRootSize) % (mGridRootSize * mGridRootSize);
+			i_max = i_min + mGridRootSize - 1;
+
+			j_min = ((K - 1) / mGridRootSize) * mGridRootSize;
+			j_max = j_min + mGridRootSize - 1;
+
+			I_MIN = i_min + 1;
+			I_MAX = i_max + 1;
+			J_MIN = j_min + 1;
+			J_MAX = j_max + 1;
+		}
+		else {
+			ret = ERR_OUT_OF_GRIDS_BOUNDS;
+		}
+
+		return ret;
+	} 
+
 }
\ No newline at end of file
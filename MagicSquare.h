@@ -1,124 +1,690 @@
-#pragma once
-
-#include <cstdint>
-#include <set>
-#include <unordered_set>
-#include <vector>
-#include <map>
-
-namespace MagicSquares {
-
-	// @todo On pourrait faire une classe template pour pouvoir utiliser autre chose que des size_t pour la grille
-
-	// Structure locale dcrivant un triplet colonne I, ligne J, valeurs Values
-	typedef struct {
-		size_t I;
-		size_t J;
-		std::unordered_set<size_t> Values;
-	} CellHypothesis;
-
-	class RegulareSquare
-	{
-	public:
-
-		enum ERROR_CODE {
-			ERR_OK = 0,
-			ERR_FORBIDDEN_VALUE,
-			ERR_OUT_OF_GRIDS_BOUNDS,
-			ERR_OUT_OF_VALUES_BOUNDS,
-			ERR_UNABLE_TO_FILL_HINTS,
-			ERR_NO_MORE_HYPOTHESIS
-		};
-
-		RegulareSquare(size_t grid_root_size);
-
-		virtual ~RegulareSquare();
-
-		ERROR_CODE completeGridWithHints(size_t hints_number);
-
-		ERROR_CODE solve(bool stop_on_first_solution = true);
-
-		size_t getValue(size_t I, size_t J);
-		ERROR_CODE setValue(size_t I, size_t J, size_t value);
-		ERROR_CODE clearCell(size_t I, size_t J);
-
-		ERROR_CODE checkValueAllowed(size_t I, size_t J, size_t value, bool & allowed) const;
-
-		ERROR_CODE checkColumn(size_t I, bool& complete) const;
-		ERROR_CODE checkRow(size_t J, bool & complete) const;
-		ERROR_CODE checkBlock(size_t K, bool& complete) const;
-		
-		bool isGridCompleted() const;
-
-		size_t filledCellsCount() const;
-
-		bool isInGridBounds(size_t I, size_t J) const;
-		bool isInValuesBounds(size_t value) const;
-
-		bool isSolved() const {
-			return mSolved;
-		};
-
-		size_t getSolutionsNumber() const {
-			return mSolutions.size();
-		};
-
-		const std::vector<RegulareSquare>& solutions() const {
-			return mSolutions;
-		};
-
-		void dump() const;
-
-		void dumpSolutions() const;
-
-		void dumpAllowedValuesNumbers() const;
-
-	private:
-
-		class InternalGrid : public std::vector< std::vector<size_t> > {
-		
-		public: 
-			InternalGrid(size_t N, size_t V) : std::vector< std::vector<size_t> > (N, std::vector<size_t>(N,0)) {
-
-			}
-
-		};
-
-		class OrderedHypothesisMap : public std::multimap<size_t, CellHypothesis> {};
-
-		static const size_t VOID_VALUE = 0;
-
-
-		size_t mGridRootSize;
-		size_t mGridHintsNumber;
-
-		size_t mMinAllowedValue;
-		size_t mMaxAllowedValue;
-
-		InternalGrid					                  mInternalGrid;         // i,j array of k values
-		std::vector< std::vector< std::set<size_t> > >    mAllowedValuesMap;     // i,j set of values V allowed in i,j
-
-		bool mSolved;
-		std::vector<RegulareSquare> mSolutions;
-
-		void resetInternalGrids();
-		void setInternalGrid(const InternalGrid& grid);
-
-		void buildHypothesisMap(OrderedHypothesisMap & hypothesis_map, bool scrambled = false) const;
-
-		bool recursiveSolve(const RegulareSquare& grid,
-							const OrderedHypothesisMap& hypothesis_map,
-							OrderedHypothesisMap::iterator next_hypothesis,
-							bool stop_on_first_solution = true);
-
-		ERROR_CODE getBlockBounds(size_t K,
-			size_t& I_MIN,
-			size_t& I_MAX,
-			size_t& J_MIN,
-			size_t& J_MAX) const;
-
-	};
-
-
-}
-
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BasicSquare.h"
+#include "RandomGenerator.h"
+#include "SolutionCountCache.h"
+#include "SolutionStore.h"
+#include "ValueMask.h"
+
+namespace MagicSquares {
+
+	// Structure locale décrivant un triplet colonne I, ligne J, valeurs Values
+	typedef struct {
+		size_t    I;
+		size_t    J;
+		ValueMask Values;
+		size_t    Weight;   // the lowest weights are tried first
+	} CellHypothesis;
+
+	class RegulareSquare
+	{
+	public:
+
+		enum ERROR_CODE {
+			ERR_OK = 0,
+			ERR_FORBIDDEN_VALUE,
+			ERR_OUT_OF_GRIDS_BOUNDS,
+			ERR_OUT_OF_VALUES_BOUNDS,
+			ERR_UNABLE_TO_FILL_HINTS,
+			ERR_NO_MORE_HYPOTHESIS,
+			ERR_MULTIPLE_SOLUTIONS,
+			ERR_INVALID_ROOT_SIZE
+		};
+
+		// How the search picks the next cell to fill
+		enum SEARCH_STRATEGY {
+			SEARCH_STATIC_ORDER = 0,   // cells ordered once by candidates number before the search
+			SEARCH_MRV,                // cell with the fewest remaining candidates at each node
+			SEARCH_MRV_DEGREE          // same, ties broken by the number of empty peers
+		};
+
+		// Algorithm used by solve()
+		enum SOLVER_BACKEND {
+			SOLVER_BACKTRACKING = 0,   // hypothesis search with constraint propagation
+			SOLVER_DANCING_LINKS       // exact cover search (Algorithm X), see DancingLinks
+		};
+
+		// How generateSolvedGrid builds a complete grid
+		enum FILL_METHOD {
+			FILL_RANDOMIZED_SEARCH = 0,   // search with random values order, restarted when stuck
+			FILL_PATTERN_TRANSFORM        // shuffled base pattern (relabeling, rows / columns / bands / stacks permutations, transpose)
+		};
+
+		// Clues layout of completeGridWithHints : the clues are removed (and given back) by orbits of symmetric cells
+		enum CLUE_SYMMETRY {
+			SYMMETRY_NONE = 0,
+			SYMMETRY_ROTATIONAL_180,       // I,J and N + 1 - I,N + 1 - J
+			SYMMETRY_DIAGONAL,             // I,J and J,I
+			SYMMETRY_HORIZONTAL_MIRROR,    // I,J and I,N + 1 - J
+			SYMMETRY_VERTICAL_MIRROR       // I,J and N + 1 - I,J
+		};
+
+		// Inferences run to a fixpoint after each hypothesis of the search (flags can be combined)
+		enum PROPAGATION_TECHNIQUE {
+			PROPAGATE_NONE           = 0x00,
+			PROPAGATE_NAKED_SINGLES  = 0x01,   // cell with a single candidate
+			PROPAGATE_HIDDEN_SINGLES = 0x02,   // value with a single position in a row, column or block
+			PROPAGATE_NAKED_PAIRS    = 0x04,   // two cells of a unit sharing the same two candidates
+			PROPAGATE_HIDDEN_PAIRS   = 0x08,   // two values of a unit sharing the same two positions
+			PROPAGATE_POINTING       = 0x10,   // pointing and claiming (box-line reduction)
+			PROPAGATE_X_WING         = 0x20,   // value on the same two positions of two rows (columns)
+			PROPAGATE_ALL            = 0x3F
+		};
+
+		// Techniques indexes (bit number of the flag) in the statistics
+		static const size_t PROPAGATION_TECHNIQUES_NUMBER = 6;
+
+		// Difficulty for a human solver, given by the hardest technique needed
+		enum DIFFICULTY_LEVEL {
+			DIFFICULTY_EASY = 0,     // singles only
+			DIFFICULTY_MEDIUM,       // pointing, naked pairs
+			DIFFICULTY_HARD,         // hidden pairs, X-wing
+			DIFFICULTY_EXPERT        // at least one guess : none of the techniques applies at some point
+		};
+
+		// Result of gradeDifficulty : each step applies the easiest technique changing the grid
+		typedef struct {
+			size_t Steps[PROPAGATION_TECHNIQUES_NUMBER];     // steps where the technique was the easiest one left
+			size_t Changes[PROPAGATION_TECHNIQUES_NUMBER];   // cells set or candidates removed by these steps
+			size_t GuessesNumber;                            // cells set from the solution when no technique applies
+			size_t Score;                                    // changes weighted by the technique difficulty, and guesses
+			DIFFICULTY_LEVEL Level;
+		} DifficultyRating;
+
+		// Counters of the searches and of the generation, accumulated until resetStatistics
+		typedef struct {
+			size_t NodesNumber;            // hypothesis tried
+			size_t BacktracksNumber;       // hypothesis undone without leading to a solution
+			size_t MaxDepth;               // deepest level of hypothesis
+			size_t SearchesNumber;         // solve, countSolutions, uniqueness checks...
+			size_t GridCopiesNumber;       // working grids copied by the searches and the generation
+			size_t RouteRestartsNumber;    // new clues removal routes of completeGridWithHints
+			size_t ClueRemovalsNumber;     // clues removal attempts of completeGridWithHints
+			size_t CacheHitsNumber;        // uniqueness checks of completeGridWithHints answered by the solutions count cache
+			size_t CacheMissesNumber;
+			size_t Eliminations[PROPAGATION_TECHNIQUES_NUMBER];  // cells set or candidates removed by each technique
+			double FillSeconds;            // solved grid generation
+			double MinimizationSeconds;    // clues removal, uniqueness checks included
+			double SearchSeconds;          // searches, propagation included
+			double PropagationSeconds;
+		} SolveStatistics;
+
+		// Supported root sizes : all the values of a cell must fit in a ValueMask
+		static const size_t MIN_GRID_ROOT_SIZE = 2;
+		static const size_t MAX_GRID_ROOT_SIZE = 8;
+
+		static bool isValidRootSize(size_t grid_root_size) {
+			return (grid_root_size >= MIN_GRID_ROOT_SIZE) && (grid_root_size <= MAX_GRID_ROOT_SIZE);
+		}
+
+		// A root size out of MIN_GRID_ROOT_SIZE..MAX_GRID_ROOT_SIZE gives an empty, invalid grid :
+		// its operations fail with ERR_INVALID_ROOT_SIZE (or find no solution)
+		RegulareSquare(size_t grid_root_size);
+
+		// Grid drawing its random choices from the given generator (copied)
+		RegulareSquare(size_t grid_root_size, const RandomGenerator& random_generator);
+
+		virtual ~RegulareSquare();
+
+		ERROR_CODE completeGridWithHints(size_t hints_number);
+
+		// Fill the grid with a random solution. The randomized search completes the current values,
+		// the pattern transform starts from an empty grid (fastest, but reaches fewer distinct grids)
+		ERROR_CODE generateSolvedGrid(FILL_METHOD method = FILL_RANDOMIZED_SEARCH);
+
+		ERROR_CODE solve(bool stop_on_first_solution = true);
+
+		// Count the solutions without storing them, stopping as soon as limit is reached (0 for no limit)
+		size_t countSolutions(size_t limit = 0);
+
+		// True if the grid has exactly one solution (the search stops at the second one)
+		bool hasUniqueSolution();
+
+		// Same, with the search bounded to nodes_limit hypothesis (0 for no limit) : false when it is reached
+		bool hasUniqueSolution(size_t nodes_limit);
+
+		// For a void cell I,J holding value in the only known solution : true if no solution has another value there.
+		// When the grid had a unique solution before the cell was cleared, this is hasUniqueSolution() with a single
+		// search for one solution instead of two.
+		// nodes_limit bounds the search (0 for no limit) : the answer is false when it is reached.
+		bool isValueForced(size_t I, size_t J, size_t value, size_t nodes_limit = 0);
+
+		// Called with the N * N values of each solution (cell i,j at i * N + j, valid during the call only), return false to stop
+		typedef std::function<bool(const GridCell* values)> SolutionVisitor;
+
+		// Stream the solutions to the visitor without storing them, up to limit solutions (0 for no limit).
+		// Returns the number of solutions found.
+		size_t enumerateSolutions(const SolutionVisitor& visitor, size_t limit = 0);
+
+		// Same as solve() on threads_number threads (0 for one per hardware thread) : the top of the
+		// search tree is split in tasks balanced between the threads by work stealing.
+		// Always uses the backtracking search with MRV cell selection.
+		ERROR_CODE solveParallel(bool stop_on_first_solution = true, size_t threads_number = 0);
+
+		// Solve the grid as a human would, with the propagation techniques from the easiest to the hardest.
+		// The grid must have a unique solution (ERR_NO_MORE_HYPOTHESIS or ERR_MULTIPLE_SOLUTIONS otherwise).
+		ERROR_CODE gradeDifficulty(DifficultyRating& rating) const;
+
+		static const char* difficultyLevelName(DIFFICULTY_LEVEL level);
+
+		size_t getValue(size_t I, size_t J);
+		ERROR_CODE setValue(size_t I, size_t J, size_t value);
+		ERROR_CODE clearCell(size_t I, size_t J);
+
+		ERROR_CODE checkValueAllowed(size_t I, size_t J, size_t value, bool & allowed) const;
+
+		ERROR_CODE checkColumn(size_t I, bool& complete) const;
+		ERROR_CODE checkRow(size_t J, bool & complete) const;
+		ERROR_CODE checkBlock(size_t K, bool& complete) const;
+		
+		bool isGridCompleted() const;
+
+		size_t filledCellsCount() const;
+
+		// Zobrist hash of the values (XOR of one key per filled cell and value), updated at each change
+		uint64_t getGridHash() const {
+			return mGridHash;
+		};
+
+		bool isInGridBounds(size_t I, size_t J) const;
+		bool isInValuesBounds(size_t value) const;
+
+		void setSearchStrategy(SEARCH_STRATEGY strategy) {
+			mSearchStrategy = strategy;
+		};
+
+		SEARCH_STRATEGY getSearchStrategy() const {
+			return mSearchStrategy;
+		};
+
+		void setSolverBackend(SOLVER_BACKEND backend) {
+			mSolverBackend = backend;
+		};
+
+		SOLVER_BACKEND getSolverBackend() const {
+			return mSolverBackend;
+		};
+
+		// Combination of PROPAGATION_TECHNIQUE flags (singles only by default : on 9 * 9 grids
+		// the pairs and pointing passes cost more per node than the branches they save)
+		void setPropagationTechniques(unsigned int techniques) {
+			mPropagationTechniques = techniques;
+		};
+
+		unsigned int getPropagationTechniques() const {
+			return mPropagationTechniques;
+		};
+
+		// Limits of completeGridWithHints (0 for none) : once reached, the grid is the lowest puzzle found
+		// and ERR_UNABLE_TO_FILL_HINTS is returned. Even without limits, the generation stops the same way when
+		// MAX_STALLED_ROUTES new routes in a row don't find a lower puzzle (hints number out of reach)
+		void setGenerationBudget(double max_seconds, size_t max_uniqueness_checks) {
+			mGenerationMaxSeconds = max_seconds;
+			mGenerationMaxChecks = max_uniqueness_checks;
+		};
+
+		// Hypothesis allowed to each uniqueness check of completeGridWithHints (0 for no limit) : past it, the clue is kept.
+		// No limit by default up to 16 * 16, BIG_GRID_UNIQUENESS_NODES_LIMIT above.
+		void setUniquenessNodesLimit(size_t nodes_limit) {
+			mUniquenessNodesLimit = nodes_limit;
+		};
+
+		static const size_t BIG_GRID_UNIQUENESS_NODES_LIMIT = 100;
+
+		// Puzzles whose uniqueness is remembered during a completeGridWithHints (0 for no cache) : the local search
+		// and the route restarts come back to the same puzzles, checked again for free
+		void setSolutionCacheSize(size_t puzzles_number) {
+			mSolutionCacheSize = puzzles_number;
+		};
+
+		static const size_t DEFAULT_SOLUTION_CACHE_SIZE = 16384;
+
+		// State of completeGridWithHints given to the progress callback
+		typedef struct {
+			size_t HintsNumber;         // clues of the current puzzle
+			size_t LowestHintsNumber;   // clues of the lowest puzzle found
+			size_t UniquenessChecks;
+			size_t RouteRestarts;
+			size_t DifficultyRejects;   // clue removals undone or puzzles dropped for their difficulty
+			double Seconds;             // since the start of the clues removal
+		} GenerationProgress;
+
+		typedef std::function<void(const GenerationProgress& progress)> ProgressCallback;
+
+		// Called every interval_seconds during completeGridWithHints, and once at the end
+		void setProgressCallback(const ProgressCallback& callback, double interval_seconds = 1.0) {
+			mProgressCallback = callback;
+			mProgressInterval = interval_seconds;
+		};
+
+		// Levels accepted by completeGridWithHints (all by default). A clue removal making the puzzle harder than
+		// max_level is undone on the spot, a puzzle easier than min_level is dropped and the search goes on.
+		void setDifficultyBand(DIFFICULTY_LEVEL min_level, DIFFICULTY_LEVEL max_level) {
+			mDifficultyMin = min_level;
+			mDifficultyMax = max_level;
+		};
+
+		// Symmetry of the clues of completeGridWithHints (none by default). Uniqueness is checked once per orbit.
+		void setClueSymmetry(CLUE_SYMMETRY symmetry) {
+			mClueSymmetry = symmetry;
+		};
+
+		CLUE_SYMMETRY getClueSymmetry() const {
+			return mClueSymmetry;
+		};
+
+		// Cells allowed to keep a clue in completeGridWithHints, row by row as in toLine (cell I,J at (J - 1) * N + I - 1),
+		// empty for all the cells (default).
+		// The other cells are cleared first : when the solution is not unique anymore, another solved grid is tried.
+		// With a clue symmetry, a cell of the mask whose image is out of it is cleared too (the clues stay symmetric).
+		void setClueMask(const std::vector<bool>& clue_cells) {
+			mClueMask = clue_cells;
+		};
+
+		// Cells of the clue mask never getting a clue because of the clue symmetry (0 for a mask closed under it)
+		size_t getAsymmetricMaskCellsNumber() const;
+
+		// Tells if completeGridWithHints may use a solved grid (deduplication) : a rejected grid is replaced by a new one
+		// before any clue is removed, up to MAX_FILTERED_SOLVED_GRIDS grids (then ERR_UNABLE_TO_FILL_HINTS)
+		typedef std::function<bool(const RegulareSquare& solved_grid)> SolvedGridFilter;
+
+		void setSolvedGridFilter(const SolvedGridFilter& filter) {
+			mSolvedGridFilter = filter;
+		};
+
+		static const size_t MAX_FILTERED_SOLVED_GRIDS = 64;
+
+		// Rating of the grid built by the last completeGridWithHints
+		const DifficultyRating& getGridDifficulty() const {
+			return mGridDifficulty;
+		};
+
+		// Hints of the grid built by the last completeGridWithHints : the lowest number reached when out of budget
+		size_t getGridHintsNumber() const {
+			return mGridHintsNumber;
+		};
+
+		// Method used by completeGridWithHints to get its solved grid
+		void setFillMethod(FILL_METHOD method) {
+			mFillMethod = method;
+		};
+
+		FILL_METHOD getFillMethod() const {
+			return mFillMethod;
+		};
+
+		// Seed of the random generator used by completeGridWithHints (a different seed for each instance by default)
+		void setRandomSeed(uint64_t seed) {
+			mRandomGenerator.seed(seed);
+		};
+
+		void setRandomGenerator(const RandomGenerator& random_generator) {
+			mRandomGenerator = random_generator;
+		};
+
+		const RandomGenerator& getRandomGenerator() const {
+			return mRandomGenerator;
+		};
+
+		// Progress messages of completeGridWithHints on std::cout
+		void setVerbose(bool verbose) {
+			mVerbose = verbose;
+		};
+
+		// The statistics cost a pointer test per hypothesis when disabled (default)
+		void setStatisticsEnabled(bool enabled) {
+			mStatisticsEnabled = enabled;
+		};
+
+		bool isStatisticsEnabled() const {
+			return mStatisticsEnabled;
+		};
+
+		const SolveStatistics& getStatistics() const {
+			return mStatistics;
+		};
+
+		void resetStatistics();
+
+		static const char* propagationTechniqueName(size_t technique_index);
+
+		// Number of hypothesis tried by the last solve
+		size_t getSearchNodesNumber() const {
+			return mSearchNodesNumber;
+		};
+
+		bool isSolved() const {
+			return mSolved;
+		};
+
+		size_t getSolutionsNumber() const {
+			return mSolutions.size();
+		};
+
+		// The solutions are stored as packed values : these build a grid for each solution asked
+		RegulareSquare solution(size_t index) const;
+
+		std::vector<RegulareSquare> solutions() const;
+
+		// N * N values of a solution (cell i,j at i * N + j)
+		const GridCell* solutionValues(size_t index) const {
+			return mSolutions[index];
+		};
+
+		size_t getGridRootSize() const {
+			return mGridRootSize;
+		};
+
+		// False when the grid was built with an unsupported root size
+		bool isValid() const {
+			return 0 != mGridRootSize;
+		};
+
+		// N * N values of the grid (cell i,j at i * N + j, 0 for a void cell)
+		const GridCell* values() const {
+			return mInternalGrid.data();
+		};
+
+		// Digits of the values 1 to 64 in the lines : 1 to 9, A to Z for 10 to 35, a to z for 36 to 61, then + / @
+		static const char* const LINE_DIGITS;
+
+		// Grid on a single line, row by row ('.' for a void cell)
+		std::string toLine() const;
+
+		// Load a grid written by toLine : '.' or '0' for a void cell, then the digits of LINE_DIGITS (lower case letters
+		// are read as upper case ones up to 35 values). The line must have N * N characters. The grid is cleared first.
+		ERROR_CODE fromLine(const char* line, size_t length);
+
+		// Load N * N values in the order of values() (0 for a void cell), with the checks of fromLine
+		ERROR_CODE fromValues(const GridCell* values);
+
+		// Root size of the grids written on length characters (0 if none)
+		static size_t rootSizeOfLine(size_t length);
+
+		void dump() const;
+
+		void dumpSolutions() const;
+
+		void dumpAllowedValuesNumbers() const;
+
+		void dumpStatistics() const;
+
+	private:
+
+		// Checks the undo trail on the private state (Tests/SearchTrailTest.cpp)
+		friend class SearchTrailTest;
+
+		// Grid of N * N values (cell i,j at i * N + j)
+		void dumpValues(const GridCell* values) const;
+
+		// Flat grids : cells in the object for the usual 9 x 9, in one heap block for the other root sizes
+		typedef BasicSquare<GridCell, STANDARD_GRID_ROOT_SIZE>  InternalGrid;
+		typedef BasicSquare<ValueMask, STANDARD_GRID_ROOT_SIZE> CandidatesGrid;
+
+		// Sorted by weight (stable : cells of the same weight in the grid order)
+		class OrderedHypothesisMap : public std::vector<CellHypothesis> {};
+
+		// Undo record of the search : candidates removed from a cell, and the value set in it (if any)
+		typedef struct {
+			size_t    Cell;       // i * N + j
+			size_t    Value;      // VOID_VALUE when only candidates were removed
+			ValueMask Removed;
+		} TrailEntry;
+
+		class SearchTrail : public std::vector<TrailEntry> {};
+
+		// State shared by all the levels of a search
+		typedef struct {
+			SearchTrail Trail;
+			size_t      SolutionsLimit;    // 0 for no limit
+			size_t      SolutionsNumber;
+			bool        StoreSolutions;    // false to only count them
+			const std::atomic<bool>* Cancel;  // set by another thread to stop the search (may be null)
+			size_t      NodesLimit;        // give up after this number of hypothesis (0 for no limit)
+			bool        RandomizeValues;   // try the values of a cell in random order
+			const SolutionVisitor* Visitor;  // called for each solution (may be null)
+			SolveStatistics* Statistics;   // null when disabled
+			size_t      Depth;             // current hypothesis level
+		} SearchContext;
+
+		// Working memory of the searches of a thread (grid copy, trail, hypothesis), kept from one search to the next
+		class SearchScratch;
+		class ScratchLease;
+
+		// Sub tree of a parallel search : the grid values once its hypothesis are set
+		typedef struct {
+			std::vector<size_t> Values;
+			size_t              Depth;
+		} ParallelTask;
+
+		static const size_t VOID_VALUE = 0;
+
+
+		size_t mGridRootSize;
+		size_t mGridHintsNumber;
+		double mGenerationMaxSeconds;
+		size_t mGenerationMaxChecks;
+		size_t mUniquenessNodesLimit;
+
+		ProgressCallback mProgressCallback;
+		double           mProgressInterval;
+
+		DIFFICULTY_LEVEL mDifficultyMin;
+		DIFFICULTY_LEVEL mDifficultyMax;
+		DifficultyRating mGridDifficulty;
+
+		CLUE_SYMMETRY     mClueSymmetry;
+		std::vector<bool> mClueMask;
+
+		SolvedGridFilter mSolvedGridFilter;
+
+		size_t mMinAllowedValue;
+		size_t mMaxAllowedValue;
+
+		InternalGrid					                  mInternalGrid;         // i,j array of k values
+		CandidatesGrid                                    mAllowedValuesMap;     // i,j mask of values V allowed in i,j
+
+		std::vector<ValueMask>                            mRowsMask;             // j mask of the values set in row J
+		std::vector<ValueMask>                            mColumnsMask;          // i mask of the values set in column I
+		std::vector<ValueMask>                            mBlocksMask;           // k mask of the values set in block K
+
+		size_t   mFilledCellsCount;
+		uint64_t mGridHash;
+		size_t   mSolutionCacheSize;
+
+		SOLVER_BACKEND  mSolverBackend;
+		SEARCH_STRATEGY mSearchStrategy;
+		unsigned int    mPropagationTechniques;
+		FILL_METHOD     mFillMethod;
+		size_t          mSearchNodesNumber;
+
+		bool                     mVerbose;
+		mutable RandomGenerator  mRandomGenerator;  // per instance : grids can be generated on several threads
+
+		bool          mSolved;
+		SolutionStore mSolutions;
+
+		bool            mStatisticsEnabled;
+		SolveStatistics mStatistics;
+
+		// Where the searches count : null when disabled
+		SolveStatistics* statistics() {
+			return mStatisticsEnabled ? &mStatistics : nullptr;
+		};
+
+		void addStatistics(const SolveStatistics& statistics);
+
+		size_t randomIndex(size_t n) const {
+			return mRandomGenerator.uniform(n);
+		};
+
+		void shuffle(std::vector<size_t>& values) const;
+
+		// Random order of the N rows (or columns) keeping the bands (or stacks) : bands order, then lines order in each band
+		void randomLinesOrder(std::vector<size_t>& lines) const;
+
+		void fillFromPattern();
+
+		// Local search of completeGridWithHints : clues given back at each move, moves without progress before a restart
+		static const size_t PERTURBATION_CLUES_NUMBER = 3;
+		static const size_t MAX_STALLED_MOVES = 256;
+		static const size_t MAX_STALLED_ROUTES = 16;       // new routes without a lower puzzle before giving up
+		static const size_t MAX_MASK_SOLVED_GRIDS = 256;   // solved grids tried for a clue mask
+
+		typedef struct {
+			std::chrono::steady_clock::time_point Start;
+			std::chrono::steady_clock::time_point LastProgress;
+			GenerationProgress                    Progress;
+			bool                                  BudgetOver;
+			const GridCell*                       Solution;      // values of the solved grid
+			std::vector<std::vector<size_t> >     Orbits;        // cells (i * N + j) removed and given back together
+			SolutionCountCache*                   Cache;         // null when disabled
+		} GenerationState;
+
+		// generateSolvedGrid until the solved grid filter accepts the grid
+		ERROR_CODE generateFilteredSolvedGrid();
+
+		// Image of the cell c (i * N + j) by the clue symmetry
+		size_t symmetricCell(size_t c) const;
+
+		bool isInClueMask(size_t c) const;
+
+		// Cell of the clue mask whose image is in the mask too : the only cells which may keep a clue
+		bool isClueCell(size_t c) const;
+
+		// Orbits of the clue cells under the clue symmetry
+		std::vector<std::vector<size_t> > clueOrbits() const;
+
+		// Clear the cells which are not clue cells, false if the puzzle is not unique anymore
+		bool clearOutOfMask(RegulareSquare& puzzle);
+
+		// Clear the clues of the puzzle orbit by orbit along a random route while its solution stays unique (down to hints_number)
+		void removeClues(RegulareSquare& puzzle, size_t hints_number, GenerationState& state);
+
+		// Difficulty band of setDifficultyBand (the puzzle is graded only when a band is set)
+		bool isInDifficultyBand(const RegulareSquare& puzzle, GenerationState& state) const;
+
+		// Give back at least clues_number random clues of the solved grid (whole orbits)
+		void restoreClues(RegulareSquare& puzzle, size_t clues_number, const GenerationState& state);
+
+		void resetInternalGrids();
+		void setInternalGrid(const InternalGrid& grid);
+
+		// Values of the cells in i * N + j order (VOID_VALUE for a void cell)
+		void exportValues(std::vector<size_t>& values) const;
+		// Reset the grid to consistent values given in i * N + j order
+		void loadValues(const std::vector<size_t>& values);
+
+		size_t blockIndex(size_t i, size_t j) const {
+			return (i / mGridRootSize) + (j / mGridRootSize) * mGridRootSize;
+		};
+
+		// Zobrist key of the value V in the cell i * N + j (V < 256)
+		static uint64_t cellKey(size_t cell, size_t V) {
+			uint64_t state = (static_cast<uint64_t>(cell) << 8) | V;
+			return RandomGenerator::splitMix64(state);
+		};
+
+		// checkValueAllowed without the bounds checks (0 based i, j)
+		ERROR_CODE checkCandidate(size_t i, size_t j, size_t V, bool& allowed) const;
+
+		// Set an allowed value and remove it from the peers candidates, recording the changes in the trail (if any)
+		void placeValue(size_t i, size_t j, size_t V, SearchTrail* trail);
+		bool removeCandidates(size_t i, size_t j, ValueMask mask, SearchTrail* trail);
+
+		// Give back a value to an empty cell if none of its units uses it (clearCell)
+		void restoreCandidate(size_t i, size_t j, ValueMask value_bit);
+
+		// Undo all the changes recorded in the trail after the mark
+		void rewindTrail(SearchTrail& trail, size_t mark);
+
+		// Cell k (0 to N-1) of unit u : rows (0 to N-1), then columns (N to 2N-1), then blocks (2N to 3N-1)
+		void unitCell(size_t u, size_t k, size_t& i, size_t& j) const;
+
+		// Run the enabled techniques until none of them changes the grid, returns false on a contradiction
+		bool propagate(SearchTrail* trail, SolveStatistics* statistics = nullptr);
+
+		// Mask of the values already set in the unit u
+		ValueMask unitValues(size_t u) const;
+
+		// One pass of each technique : returns false on a contradiction, counts the grid changes
+		bool applyNakedSingles(SearchTrail* trail, size_t& changes);
+		bool applyHiddenSingles(SearchTrail* trail, size_t& changes);
+		bool applyNakedPairs(SearchTrail* trail, size_t& changes);
+		bool applyHiddenPairs(SearchTrail* trail, size_t& changes);
+		bool applyPointing(SearchTrail* trail, size_t& changes);
+		bool applyXWing(SearchTrail* trail, size_t& changes);
+
+		// Pass of the technique of index technique_index (see PROPAGATION_TECHNIQUES_NUMBER)
+		bool applyTechnique(size_t technique_index, SearchTrail* trail, size_t& changes);
+
+		// Same as the public one for a puzzle of known solution (N * N values), without any search
+		ERROR_CODE gradeDifficulty(DifficultyRating& rating, const GridCell* solution) const;
+
+		// Level of a puzzle of known solution (DIFFICULTY_EXPERT if it can't be graded)
+		DIFFICULTY_LEVEL difficultyLevel(const GridCell* solution) const;
+
+		void buildHypothesisMap(OrderedHypothesisMap & hypothesis_map, bool scrambled = false) const;
+
+		// Search up to solutions_limit solutions (0 for all) with the selected backend, returns the number found
+		size_t runSearch(size_t solutions_limit, bool store_solutions, const SolutionVisitor* visitor = nullptr, size_t nodes_limit = 0);
+
+		void recordSolution(const RegulareSquare& grid, SearchContext& context);
+
+		// Statistics of an hypothesis once its sub tree is searched
+		static void countHypothesis(SearchContext& context, bool solved) {
+			if (context.Statistics != nullptr) {
+				context.Statistics->NodesNumber++;
+				if (context.Depth > context.Statistics->MaxDepth) {
+					context.Statistics->MaxDepth = context.Depth;
+				}
+				if (!solved) {
+					context.Statistics->BacktracksNumber++;
+				}
+			}
+		};
+
+		bool isSearchOver(const SearchContext& context) const {
+			return ((context.SolutionsLimit != 0) && (context.SolutionsNumber >= context.SolutionsLimit)) ||
+				   ((context.NodesLimit != 0) && (mSearchNodesNumber >= context.NodesLimit)) ||
+				   ((context.Cancel != nullptr) && context.Cancel->load(std::memory_order_relaxed));
+		};
+
+		bool recursiveSolve(RegulareSquare& grid,
+							SearchContext& context,
+							const OrderedHypothesisMap& hypothesis_map,
+							OrderedHypothesisMap::const_iterator next_hypothesis);
+
+		void solveExactCover(SearchContext& context);
+
+		// Pick the empty cell with the fewest candidates, returns false if the grid is complete
+		bool selectMostConstrainedCell(size_t& i, size_t& j) const;
+
+		bool recursiveSolveMRV(RegulareSquare& grid,
+							   SearchContext& context);
+
+		// Expand a task of a parallel search (split it above split_depth, search it below), see MagicSquareParallel.cpp
+		void processParallelTask(RegulareSquare& grid,
+								 SearchContext& context,
+								 const ParallelTask& task,
+								 size_t split_depth,
+								 std::vector<ParallelTask>& children);
+
+		ERROR_CODE getBlockBounds(size_t K,
+			size_t& I_MIN,
+			size_t& I_MAX,
+			size_t& J_MIN,
+			size_t& J_MAX) const;
+
+	};
+
+
+}
+
@@ -0,0 +1,214 @@
+// Benchmark of the solver and generator hot paths on fixed puzzle sets.
+// One JSON object per line on std::cout, so that the results of two commits can be compared :
+//
+//   MagicSquareBenchmark [--label L] [--repeat R] [--generate N] [--seed S] [--kernels K] [--quick]
+//
+// - solve       : latency percentiles (microseconds) and search nodes of solve(true), per set and backend
+// - solve_all   : solutions per second of solve(false) on the multiple solutions set
+// - generate    : puzzles per minute of completeGridWithHints, for several hints numbers (fixed seed)
+//
+// --kernels forces the propagation kernels (scalar, sse4.1, avx2) instead of the best ones of the CPU.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CandidateKernels.h"
+#include "MagicSquare.h"
+#include "PuzzleBatchGenerator.h"
+
+namespace {
+
+	typedef struct {
+		const char*              Name;
+		std::vector<std::string> Puzzles;
+	} PuzzleSet;
+
+	const std::vector<PuzzleSet>& puzzleSets() {
+		static const std::vector<PuzzleSet> sets = {
+			{ "easy", {
+				"530070000600195000098000060800060003400803001700020006060000280000419005000080079",
+				"003020600900305001001806400008102900700000008006708200002609500800203009005010300",
+				"200080300060070084030500209000105408000000000402706000301007040720040060004010003" } },
+			{ "hard", {
+				"800000000003600000070090000050007000000045700000100030001000068008500010090000400",
+				"100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+				"000000039000001005003050800008090006070002000100400000009080050020000600400700000",
+				"000000012000000003002300400001800005060070800000009000008500000900040500470006000" } },
+			{ "minimal17", {
+				"000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+				"000000010400000000020000000000050604008000300001090000300400200050100000000807000",
+				"000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+				"000000012003600000000007000410020000000500300700000600280000040000300500000000000" } },
+			{ "multiple", {
+				"000000000000003085001020000000500000004000100090000000500000073002010000000040009" } },
+			{ "grid16", {
+				"....AC........FE......B586.....A....62..A7.E9G..B.8F..G35.....62G1...BFC..D.......36G.1...4.......D....4.8.G...3...B..8..A56F.D..8.GEA37....C.9..46C.....F...38.7B......2..4..GF.....5.F..7.1.2...B.3......D..7.EFA.....3.C.G.58D.7.C.4..G......8.13...69.2...B.",
+				".241...E..7..6........8.....54.....B.F27..9A1....6G7.1....8.9.3.1..8..736...DF...CA..8...E.....6.....4.....8AE....6.....C.G4..5.6...7..CD...E1.GC..A.DE.3.F....B..F4....A..E.C.8D7..45...B..3....4....AB8.E1..F.78E3..G12A6..D.4.B.........7.....5...7..B3.9...A",
+				"1.4..7..2F.E5.6.....65.4D...287.7.8..13.C..5........F....3.1E.C.4.........6.31...B......8.1..D.C..6.82GC.......958.GA4E....D...F3....G..94F.C..D......1..2....B5.1...DF6...8...4B95...C..........2....476.EF1......E19.FB7D...4283...AB24......6.G.45..........." } }
+		};
+		return sets;
+	}
+
+	double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Nearest rank percentile of sorted values
+	double percentile(const std::vector<double>& sorted_values, double p) {
+		if (sorted_values.empty()) {
+			return 0.0;
+		}
+		size_t rank = static_cast<size_t>(p * sorted_values.size() / 100.0 + 0.5);
+		rank = (rank == 0) ? 0 : rank - 1;
+		return sorted_values[std::min(rank, sorted_values.size() - 1)];
+	}
+
+	const char* backendName(MagicSquares::RegulareSquare::SOLVER_BACKEND backend) {
+		return (backend == MagicSquares::RegulareSquare::SOLVER_DANCING_LINKS) ? "dancing_links" : "backtracking";
+	}
+
+	bool loadPuzzle(MagicSquares::RegulareSquare& grid, const std::string& puzzle) {
+		grid.setVerbose(false);
+		return grid.fromLine(puzzle.data(), puzzle.size()) == MagicSquares::RegulareSquare::ERR_OK;
+	}
+
+	void benchmarkSolve(const std::string& label, const PuzzleSet& set, MagicSquares::RegulareSquare::SOLVER_BACKEND backend, size_t repeat) {
+		std::vector<double> latencies;
+		size_t nodes = 0;
+		size_t failures = 0;
+
+		for (const std::string& puzzle : set.Puzzles) {
+			const size_t root_size = MagicSquares::RegulareSquare::rootSizeOfLine(puzzle.size());
+			for (size_t r = 0; r < repeat; r++) {
+				MagicSquares::RegulareSquare grid(root_size);
+				grid.setSolverBackend(backend);
+				if (!loadPuzzle(grid, puzzle)) {
+					failures++;
+					continue;
+				}
+
+				auto start = std::chrono::steady_clock::now();
+				grid.solve(true);
+				latencies.push_back(elapsedSeconds(start) * 1e6);
+
+				nodes += grid.getSearchNodesNumber();
+				failures += grid.isSolved() ? 0 : 1;
+			}
+		}
+
+		std::sort(latencies.begin(), latencies.end());
+		double total = 0.0;
+		for (double latency : latencies) {
+			total += latency;
+		}
+		const size_t runs = latencies.size();
+
+		std::cout << "{\"label\":\"" << label << "\",\"benchmark\":\"solve\",\"set\":\"" << set.Name
+				  << "\",\"backend\":\"" << backendName(backend) << "\",\"kernels\":\"" << MagicSquares::candidateKernels().Name << "\",\"puzzles\":" << set.Puzzles.size()
+				  << ",\"runs\":" << runs << ",\"failures\":" << failures
+				  << ",\"mean_us\":" << (runs ? total / runs : 0.0)
+				  << ",\"p50_us\":" << percentile(latencies, 50) << ",\"p90_us\":" << percentile(latencies, 90)
+				  << ",\"p99_us\":" << percentile(latencies, 99) << ",\"max_us\":" << (runs ? latencies.back() : 0.0)
+				  << ",\"mean_nodes\":" << (runs ? static_cast<double>(nodes) / runs : 0.0) << "}" << std::endl;
+	}
+
+	void benchmarkSolveAll(const std::string& label, const PuzzleSet& set, MagicSquares::RegulareSquare::SOLVER_BACKEND backend, size_t repeat) {
+		size_t solutions = 0;
+		size_t nodes = 0;
+		double seconds = 0.0;
+
+		for (const std::string& puzzle : set.Puzzles) {
+			for (size_t r = 0; r < repeat; r++) {
+				MagicSquares::RegulareSquare grid(MagicSquares::RegulareSquare::rootSizeOfLine(puzzle.size()));
+				grid.setSolverBackend(backend);
+				if (!loadPuzzle(grid, puzzle)) {
+					continue;
+				}
+
+				auto start = std::chrono::steady_clock::now();
+				grid.solve(false);
+				seconds += elapsedSeconds(start);
+
+				solutions += grid.getSolutionsNumber();
+				nodes += grid.getSearchNodesNumber();
+			}
+		}
+
+		std::cout << "{\"label\":\"" << label << "\",\"benchmark\":\"solve_all\",\"set\":\"" << set.Name
+				  << "\",\"backend\":\"" << backendName(backend) << "\",\"solutions\":" << solutions
+				  << ",\"nodes\":" << nodes << ",\"seconds\":" << seconds
+				  << ",\"solutions_per_s\":" << (seconds > 0.0 ? solutions / seconds : 0.0) << "}" << std::endl;
+	}
+
+	void benchmarkGenerate(const std::string& label, size_t hints_number, size_t puzzles_number, uint64_t seed) {
+		// One thread : the figure follows the code, not the machine load
+		MagicSquares::PuzzleBatchGenerator generator(3, 1);
+		generator.setSeed(seed);
+
+		auto start = std::chrono::steady_clock::now();
+		size_t generated = generator.generate(puzzles_number, hints_number, [](size_t, const MagicSquares::RegulareSquare&) {});
+		double seconds = elapsedSeconds(start);
+
+		std::cout << "{\"label\":\"" << label << "\",\"benchmark\":\"generate\",\"hints\":" << hints_number
+				  << ",\"puzzles\":" << generated << ",\"seed\":" << seed << ",\"seconds\":" << seconds
+				  << ",\"puzzles_per_minute\":" << (seconds > 0.0 ? 60.0 * generated / seconds : 0.0) << "}" << std::endl;
+	}
+
+}
+
+int main(int argc, char** argv) {
+
+	std::locale::global(std::locale("C"));
+
+	std::string label = "current";
+	size_t      repeat = 5;
+	size_t      generate_count = 50;
+	uint64_t    seed = 1;
+
+	for (int a = 1; a < argc; a++) {
+		if ((strcmp(argv[a], "--label") == 0) && (a + 1 < argc)) {
+			label = argv[++a];
+		} else if ((strcmp(argv[a], "--repeat") == 0) && (a + 1 < argc)) {
+			repeat = atoi(argv[++a]);
+		} else if ((strcmp(argv[a], "--generate") == 0) && (a + 1 < argc)) {
+			generate_count = atoi(argv[++a]);
+		} else if ((strcmp(argv[a], "--seed") == 0) && (a + 1 < argc)) {
+			seed = strtoull(argv[++a], nullptr, 10);
+		} else if ((strcmp(argv[a], "--kernels") == 0) && (a + 1 < argc)) {
+			if (!MagicSquares::useCandidateKernels(argv[++a])) {
+				std::cerr << "Kernels " << argv[a] << " not available on this CPU" << std::endl;
+				return 1;
+			}
+		} else if (strcmp(argv[a], "--quick") == 0) {
+			repeat = 1;
+			generate_count = 10;
+		}
+	}
+
+	const MagicSquares::RegulareSquare::SOLVER_BACKEND backends[] = {
+		MagicSquares::RegulareSquare::SOLVER_BACKTRACKING,
+		MagicSquares::RegulareSquare::SOLVER_DANCING_LINKS
+	};
+
+	for (const PuzzleSet& set : puzzleSets()) {
+		for (auto backend : backends) {
+			if (strcmp(set.Name, "multiple") == 0) {
+				benchmarkSolveAll(label, set, backend, repeat);
+			} else {
+				benchmarkSolve(label, set, backend, repeat);
+			}
+		}
+	}
+
+	const size_t hints_numbers[] = { 32, 28, 25, 23 };
+	for (size_t hints_number : hints_numbers) {
+		benchmarkGenerate(label, hints_number, generate_count, seed);
+	}
+
+	return 0;
+}
@@ -1,78 +1,380 @@
-#include <iostream>
-#include "MagicSquare.h"
-
-#define BUILD 1
-#define SOLVE 2
-
-int main(int argc, char** argv) {
-
-	std::locale::global(std::locale("C"));
-
-	// 9 * 9 regular grid instance (ROOT SIZE = 3)
-	MagicSquares::RegulareSquare regular_grid(3);
-
-#if BUILD
-
-	size_t hints_count = 25;
-
-	if (argc > 1) {
-		hints_count = atoi(argv[1]);
-	}
-
-	std::cout << "--------------------------- Create random grid with " << hints_count << " hints -------------------------------" << std::endl;
-
-	regular_grid.completeGridWithHints(hints_count);
-
-#endif
-
-#if SOLVE
-#if !BUILD
-	regular_grid.setValue(6, 1, 7);
-	regular_grid.setValue(8, 1, 5);
-
-	regular_grid.setValue(3, 2, 7);
-	regular_grid.setValue(5, 2, 3);
-	regular_grid.setValue(7, 2, 2);
-	regular_grid.setValue(9, 2, 6);
-
-	regular_grid.setValue(2, 3, 4);
-	regular_grid.setValue(4, 3, 1);
-	regular_grid.setValue(9, 3, 7);
-
-	regular_grid.setValue(4, 4, 6);
-
-	regular_grid.setValue(1, 5, 9);
-	regular_grid.setValue(3, 5, 1);
-	regular_grid.setValue(5, 5, 8);
-	regular_grid.setValue(6, 5, 3);
-
-	regular_grid.setValue(2, 6, 7);
-	regular_grid.setValue(5, 6, 2);
-	regular_grid.setValue(7, 6, 3);
-	regular_grid.setValue(8, 6, 1);
-
-	regular_grid.setValue(3, 7, 4);
-	regular_grid.setValue(6, 7, 1);
-	regular_grid.setValue(7, 7, 6);
-	regular_grid.setValue(8, 7, 3);
-	regular_grid.setValue(9, 7, 9);
-
-	regular_grid.setValue(3, 8, 8);
-
-	regular_grid.setValue(2, 9, 9);
-	regular_grid.setValue(7, 9, 5);
-#endif
-
-
-	std::cout << "------------------------------- Solve grid -----------------------------------" << std::endl;
-	regular_grid.solve(false);
-	std::cout << "------------------------------ Initial grid ----------------------------------" << std::endl;
-	regular_grid.dump();
-	std::cout << "-------------------------------- Solutions -----------------------------------" << std::endl;
-	regular_grid.dumpSolutions();
-
-#endif
-
-
-
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BatchSolver.h"
+#include "CanonicalIndex.h"
+#include "MagicSquare.h"
+#include "PuzzleBank.h"
+#include "PuzzleBankWriter.h"
+#include "PuzzleBatchGenerator.h"
+#include "PuzzleReader.h"
+
+#define BUILD 1
+#define SOLVE 2
+
+// "hard" or "medium:expert" : band of difficulty levels
+static bool parseDifficultyBand(const char* text, MagicSquares::RegulareSquare::DIFFICULTY_LEVEL& min_level, MagicSquares::RegulareSquare::DIFFICULTY_LEVEL& max_level) {
+	const char* separator = strchr(text, ':');
+	const size_t min_length = (separator != nullptr) ? static_cast<size_t>(separator - text) : strlen(text);
+	const char* max_text = (separator != nullptr) ? separator + 1 : text;
+
+	bool min_found = false;
+	bool max_found = false;
+	for (int l = MagicSquares::RegulareSquare::DIFFICULTY_EASY; l <= MagicSquares::RegulareSquare::DIFFICULTY_EXPERT; l++) {
+		const MagicSquares::RegulareSquare::DIFFICULTY_LEVEL level = static_cast<MagicSquares::RegulareSquare::DIFFICULTY_LEVEL>(l);
+		const char* name = MagicSquares::RegulareSquare::difficultyLevelName(level);
+		if ((strlen(name) == min_length) && (strncmp(name, text, min_length) == 0)) {
+			min_level = level;
+			min_found = true;
+		}
+		if (strcmp(name, max_text) == 0) {
+			max_level = level;
+			max_found = true;
+		}
+	}
+	return min_found && max_found && (min_level <= max_level);
+}
+
+static bool parseClueSymmetry(const char* text, MagicSquares::RegulareSquare::CLUE_SYMMETRY& symmetry) {
+	static const char* names[] = { "none", "rotational", "diagonal", "horizontal", "vertical" };
+	for (int s = MagicSquares::RegulareSquare::SYMMETRY_NONE; s <= MagicSquares::RegulareSquare::SYMMETRY_VERTICAL_MIRROR; s++) {
+		if (strcmp(names[s], text) == 0) {
+			symmetry = static_cast<MagicSquares::RegulareSquare::CLUE_SYMMETRY>(s);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Mask written as a grid line : '.' or '0' for a cell without clue, any other character for a cell which may keep one
+static std::vector<bool> parseClueMask(const char* text) {
+	std::vector<bool> clue_cells;
+	for (const char* c = text; *c != '\0'; c++) {
+		clue_cells.push_back((*c != '.') && (*c != '0'));
+	}
+	return clue_cells;
+}
+
+int main(int argc, char** argv) {
+
+	std::locale::global(std::locale("C"));
+
+	size_t   root_size = 3;
+	size_t   hints_count = 25;
+	size_t   batch_count = 0;
+	size_t   threads_count = 0;
+	bool     seeded = false;
+	uint64_t seed = 0;
+	const char* solve_path = nullptr;
+	bool     check_uniqueness = false;
+	bool     statistics = false;
+	double   max_seconds = 0.0;
+	bool     progress = false;
+	MagicSquares::RegulareSquare::DIFFICULTY_LEVEL difficulty_min = MagicSquares::RegulareSquare::DIFFICULTY_EASY;
+	MagicSquares::RegulareSquare::DIFFICULTY_LEVEL difficulty_max = MagicSquares::RegulareSquare::DIFFICULTY_EXPERT;
+	MagicSquares::RegulareSquare::CLUE_SYMMETRY    clue_symmetry = MagicSquares::RegulareSquare::SYMMETRY_NONE;
+	std::vector<bool> clue_mask;
+	MagicSquares::PuzzleBatchGenerator::DEDUPLICATION_MODE dedup_mode = MagicSquares::PuzzleBatchGenerator::DEDUP_NONE;
+	const char* index_path = nullptr;
+	const char* bank_path = nullptr;
+	const char* read_bank_path = nullptr;
+	bool     bank_id_given = false;
+	size_t   bank_id = 0;
+
+	// MagicSquareCreator [hints] [--root R] [--batch N] [--threads T] [--seed S] [--max-seconds S] [--stats] [--progress] [--difficulty MIN[:MAX]]
+	//                    [--symmetry none|rotational|diagonal|horizontal|vertical] [--mask LINE] [--dedup grids|puzzles [--index FILE]] [--bank FILE]
+	// MagicSquareCreator --solve-file FILE|- [--unique] [--threads T]
+	// MagicSquareCreator --read-bank FILE [--id K]
+	for (int a = 1; a < argc; a++) {
+		if ((strcmp(argv[a], "--batch") == 0) && (a + 1 < argc)) {
+			batch_count = atoi(argv[++a]);
+		} else if ((strcmp(argv[a], "--threads") == 0) && (a + 1 < argc)) {
+			threads_count = atoi(argv[++a]);
+		} else if ((strcmp(argv[a], "--seed") == 0) && (a + 1 < argc)) {
+			seed = strtoull(argv[++a], nullptr, 10);
+			seeded = true;
+		} else if ((strcmp(argv[a], "--solve-file") == 0) && (a + 1 < argc)) {
+			solve_path = argv[++a];
+		} else if (strcmp(argv[a], "--unique") == 0) {
+			check_uniqueness = true;
+		} else if ((strcmp(argv[a], "--max-seconds") == 0) && (a + 1 < argc)) {
+			max_seconds = atof(argv[++a]);
+		} else if (strcmp(argv[a], "--stats") == 0) {
+			statistics = true;
+		} else if ((strcmp(argv[a], "--root") == 0) && (a + 1 < argc)) {
+			const int root = atoi(argv[++a]);
+			if ((root < 0) || !MagicSquares::RegulareSquare::isValidRootSize(static_cast<size_t>(root))) {
+				std::cerr << "Unsupported root size " << argv[a] << " (" << MagicSquares::RegulareSquare::MIN_GRID_ROOT_SIZE
+						  << " to " << MagicSquares::RegulareSquare::MAX_GRID_ROOT_SIZE << ")" << std::endl;
+				return 1;
+			}
+			root_size = root;
+		} else if (strcmp(argv[a], "--progress") == 0) {
+			progress = true;
+		} else if ((strcmp(argv[a], "--difficulty") == 0) && (a + 1 < argc)) {
+			if (!parseDifficultyBand(argv[++a], difficulty_min, difficulty_max)) {
+				std::cerr << "Unknown difficulty " << argv[a] << " (easy, medium, hard, expert or MIN:MAX)" << std::endl;
+				return 1;
+			}
+		} else if ((strcmp(argv[a], "--symmetry") == 0) && (a + 1 < argc)) {
+			if (!parseClueSymmetry(argv[++a], clue_symmetry)) {
+				std::cerr << "Unknown symmetry " << argv[a] << " (none, rotational, diagonal, horizontal, vertical)" << std::endl;
+				return 1;
+			}
+		} else if ((strcmp(argv[a], "--mask") == 0) && (a + 1 < argc)) {
+			clue_mask = parseClueMask(argv[++a]);
+		} else if ((strcmp(argv[a], "--dedup") == 0) && (a + 1 < argc)) {
+			a++;
+			if (strcmp(argv[a], "grids") == 0) {
+				dedup_mode = MagicSquares::PuzzleBatchGenerator::DEDUP_SOLVED_GRIDS;
+			} else if (strcmp(argv[a], "puzzles") == 0) {
+				dedup_mode = MagicSquares::PuzzleBatchGenerator::DEDUP_PUZZLES;
+			} else {
+				std::cerr << "Unknown deduplication " << argv[a] << " (grids, puzzles)" << std::endl;
+				return 1;
+			}
+		} else if ((strcmp(argv[a], "--index") == 0) && (a + 1 < argc)) {
+			index_path = argv[++a];
+		} else if ((strcmp(argv[a], "--bank") == 0) && (a + 1 < argc)) {
+			bank_path = argv[++a];
+		} else if ((strcmp(argv[a], "--read-bank") == 0) && (a + 1 < argc)) {
+			read_bank_path = argv[++a];
+		} else if ((strcmp(argv[a], "--id") == 0) && (a + 1 < argc)) {
+			bank_id = strtoull(argv[++a], nullptr, 10);
+			bank_id_given = true;
+		} else {
+			hints_count = atoi(argv[a]);
+		}
+	}
+
+	if (read_bank_path != nullptr) {
+		// One puzzle per line : id, puzzle, hints, difficulty level and score
+		MagicSquares::PuzzleBank bank(read_bank_path);
+		if (!bank.isOpen()) {
+			std::cerr << "Unable to open the puzzle bank " << read_bank_path << std::endl;
+			return 1;
+		}
+		if (bank_id_given && (bank_id >= bank.size())) {
+			std::cerr << "No puzzle " << bank_id << " in " << read_bank_path << " (" << bank.size() << " puzzles)" << std::endl;
+			return 1;
+		}
+
+		MagicSquares::RegulareSquare grid(bank.getRootSize());
+		grid.setVerbose(false);
+		const size_t first_id = bank_id_given ? bank_id : 0;
+		const size_t end_id = bank_id_given ? bank_id + 1 : bank.size();
+		for (size_t id = first_id; id < end_id; id++) {
+			const MagicSquares::PuzzleBank::PuzzleMetadata metadata = bank.metadata(id);
+			if (bank.load(id, grid) != MagicSquares::RegulareSquare::ERR_OK) {
+				std::cout << id << " invalid" << '\n';
+				continue;
+			}
+			std::cout << id << " " << grid.toLine() << " " << metadata.HintsNumber << " "
+					  << MagicSquares::RegulareSquare::difficultyLevelName(metadata.Level) << " " << metadata.Score << '\n';
+		}
+		std::cout.flush();
+		return 0;
+	}
+
+	if (solve_path != nullptr) {
+		// Batch solve : one puzzle per line (81 characters for 9 * 9, N * N in general), one result per line
+		// in the input order : the solution, or the puzzle followed by the reason of the failure
+		MagicSquares::PuzzleReader reader(solve_path);
+		if (!reader.isOpen()) {
+			std::cerr << "Unable to open " << solve_path << std::endl;
+			return 1;
+		}
+
+		MagicSquares::BatchSolver solver(threads_count);
+		solver.setCheckUniqueness(check_uniqueness);
+
+		std::cerr << "Solve " << solve_path << (reader.isMapped() ? " (mapped)" : "") << " on " << solver.getThreadsNumber() << " threads" << std::endl;
+
+		auto start = std::chrono::steady_clock::now();
+
+		size_t solved = solver.solve(reader, [](size_t, MagicSquares::BatchSolver::PUZZLE_STATUS status, const std::string& puzzle, const std::string& solution) {
+			if (status == MagicSquares::BatchSolver::PUZZLE_SOLVED) {
+				std::cout << solution << '\n';
+			} else {
+				std::cout << puzzle << ' ' << MagicSquares::BatchSolver::statusName(status) << '\n';
+			}
+		});
+		std::cout.flush();
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cerr << solved << " puzzles in " << seconds << " s (" << (solved / seconds) << " puzzles/s) : ";
+		for (size_t s = MagicSquares::BatchSolver::PUZZLE_SOLVED; s <= MagicSquares::BatchSolver::PUZZLE_INVALID; s++) {
+			const MagicSquares::BatchSolver::PUZZLE_STATUS status = static_cast<MagicSquares::BatchSolver::PUZZLE_STATUS>(s);
+			std::cerr << solver.getStatusNumber(status) << " " << MagicSquares::BatchSolver::statusName(status) << " ";
+		}
+		std::cerr << std::endl;
+
+		return 0;
+	}
+
+	// Regular grid instance (ROOT SIZE = 3 : 9 * 9, 5 : 25 * 25...)
+	MagicSquares::RegulareSquare regular_grid(root_size);
+	regular_grid.setClueSymmetry(clue_symmetry);
+	regular_grid.setClueMask(clue_mask);
+
+	// The clues stay symmetric : the cells of the mask without their image in it are left void
+	const size_t asymmetric_cells = regular_grid.getAsymmetricMaskCellsNumber();
+	if (asymmetric_cells != 0) {
+		std::cerr << "Mask not closed under the symmetry : " << asymmetric_cells << " cells without their symmetric cell never get a clue" << std::endl;
+	}
+
+#if BUILD
+
+	if (batch_count > 0) {
+		// Batch mode : one puzzle per line on std::cout, as soon as it is completed
+		MagicSquares::PuzzleBatchGenerator generator(root_size, threads_count);
+		if (seeded) {
+			generator.setSeed(seed);
+		}
+		generator.setGenerationBudget(max_seconds, 0);
+		generator.setDifficultyBand(difficulty_min, difficulty_max);
+		generator.setClueSymmetry(clue_symmetry);
+		generator.setClueMask(clue_mask);
+
+		// Canonical forms of this batch, and of the previous ones kept in the index file
+		MagicSquares::CanonicalIndex index;
+		if ((dedup_mode != MagicSquares::PuzzleBatchGenerator::DEDUP_NONE) && (index_path != nullptr)) {
+			if (!index.open(index_path)) {
+				std::cerr << "Unable to open " << index_path << std::endl;
+				return 1;
+			}
+			std::cerr << index.getLoadedNumber() << " canonical forms in " << index_path << std::endl;
+		}
+		generator.setDeduplication(&index, dedup_mode);
+
+		// Binary bank of the puzzles, next to the lines
+		std::unique_ptr<MagicSquares::PuzzleBankWriter> bank;
+		if (bank_path != nullptr) {
+			bank.reset(new MagicSquares::PuzzleBankWriter(bank_path, root_size));
+			if (!bank->isOpen()) {
+				std::cerr << "Unable to write the puzzle bank " << bank_path << " (not a bank of this root size ?)" << std::endl;
+				return 1;
+			}
+		}
+
+		std::cerr << "Create " << batch_count << " random grids with " << hints_count << " hints on "
+			      << generator.getThreadsNumber() << " threads (seed " << generator.getSeed() << ")" << std::endl;
+
+		auto start = std::chrono::steady_clock::now();
+
+		size_t generated = generator.generate(batch_count, hints_count, [&bank](size_t puzzle_index, const MagicSquares::RegulareSquare& puzzle) {
+			std::cout << puzzle_index << " " << puzzle.toLine() << std::endl;
+			if (bank) {
+				bank->append(puzzle);
+			}
+		});
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cerr << generated << " grids in " << seconds << " s (" << (generated / seconds) << " grids/s)";
+		if (dedup_mode != MagicSquares::PuzzleBatchGenerator::DEDUP_NONE) {
+			std::cerr << ", " << generator.getDuplicatesNumber() << " duplicates rejected";
+		}
+		std::cerr << std::endl;
+
+		return 0;
+	}
+
+	// Always start from a known seed, so that any grid can be built again with --seed
+	if (!seeded) {
+		seed = (static_cast<uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+	}
+	regular_grid.setRandomSeed(seed);
+	regular_grid.setStatisticsEnabled(statistics);
+
+	std::cout << "--------------------------- Create random grid with " << hints_count << " hints (seed " << seed << ") ------------------" << std::endl;
+
+	regular_grid.setGenerationBudget(max_seconds, 0);
+	regular_grid.setDifficultyBand(difficulty_min, difficulty_max);
+	if (progress) {
+		// Big grids take a while : report the clues removal on std::cerr
+		regular_grid.setProgressCallback([](const MagicSquares::RegulareSquare::GenerationProgress& state) {
+			std::cerr << state.Seconds << " s : " << state.HintsNumber << " hints (lowest " << state.LowestHintsNumber << "), "
+					  << state.UniquenessChecks << " uniqueness checks, " << state.RouteRestarts << " new routes, "
+					  << state.DifficultyRejects << " difficulty rejects" << std::endl;
+		});
+	}
+	if (regular_grid.completeGridWithHints(hints_count) != MagicSquares::RegulareSquare::ERR_OK) {
+		std::cout << "Hints number not reached : lowest grid found with " << regular_grid.getGridHintsNumber() << " hints" << std::endl;
+	}
+
+	const MagicSquares::RegulareSquare::DifficultyRating& rating = regular_grid.getGridDifficulty();
+	std::cout << "Difficulty : " << MagicSquares::RegulareSquare::difficultyLevelName(rating.Level) << " (score " << rating.Score
+			  << ", " << rating.GuessesNumber << " guesses)";
+	for (size_t t = 0; t < MagicSquares::RegulareSquare::PROPAGATION_TECHNIQUES_NUMBER; t++) {
+		if (rating.Steps[t] > 0) {
+			std::cout << ", " << MagicSquares::RegulareSquare::propagationTechniqueName(t) << " " << rating.Changes[t] << " in " << rating.Steps[t] << " steps";
+		}
+	}
+	std::cout << std::endl;
+
+#endif
+
+#if SOLVE
+#if !BUILD
+	regular_grid.setValue(6, 1, 7);
+	regular_grid.setValue(8, 1, 5);
+
+	regular_grid.setValue(3, 2, 7);
+	regular_grid.setValue(5, 2, 3);
+	regular_grid.setValue(7, 2, 2);
+	regular_grid.setValue(9, 2, 6);
+
+	regular_grid.setValue(2, 3, 4);
+	regular_grid.setValue(4, 3, 1);
+	regular_grid.setValue(9, 3, 7);
+
+	regular_grid.setValue(4, 4, 6);
+
+	regular_grid.setValue(1, 5, 9);
+	regular_grid.setValue(3, 5, 1);
+	regular_grid.setValue(5, 5, 8);
+	regular_grid.setValue(6, 5, 3);
+
+	regular_grid.setValue(2, 6, 7);
+	regular_grid.setValue(5, 6, 2);
+	regular_grid.setValue(7, 6, 3);
+	regular_grid.setValue(8, 6, 1);
+
+	regular_grid.setValue(3, 7, 4);
+	regular_grid.setValue(6, 7, 1);
+	regular_grid.setValue(7, 7, 6);
+	regular_grid.setValue(8, 7, 3);
+	regular_grid.setValue(9, 7, 9);
+
+	regular_grid.setValue(3, 8, 8);
+
+	regular_grid.setValue(2, 9, 9);
+	regular_grid.setValue(7, 9, 5);
+#endif
+
+
+	std::cout << "------------------------------- Solve grid -----------------------------------" << std::endl;
+	if (threads_count > 1) {
+		regular_grid.solveParallel(false, threads_count);
+	} else {
+		regular_grid.solve(false);
+	}
+	std::cout << "Search nodes : " << regular_grid.getSearchNodesNumber() << std::endl;
+	std::cout << "------------------------------ Initial grid ----------------------------------" << std::endl;
+	regular_grid.dump();
+	std::cout << "-------------------------------- Solutions -----------------------------------" << std::endl;
+	regular_grid.dumpSolutions();
+	if (regular_grid.isStatisticsEnabled()) {
+		std::cout << "------------------------------- Statistics -----------------------------------" << std::endl;
+		regular_grid.dumpStatistics();
+	}
+
+#endif
+
+
+
 }
\ No newline at end of file
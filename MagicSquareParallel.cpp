@@ -0,0 +1,235 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MagicSquare.h"
+#include "WorkStealingQueue.h"
+
+namespace MagicSquares {
+
+	RegulareSquare::ERROR_CODE RegulareSquare::solveParallel(bool stop_on_first_solution, size_t threads_number) {
+
+		RegulareSquare::ERROR_CODE ret = ERR_OK;
+
+		if (!this->isValid()) {
+			return ERR_INVALID_ROOT_SIZE;
+		}
+
+		// Switch back to unsolved status
+		mSolved = false;
+		mSolutions.clear();
+
+		mSearchNodesNumber = 0;
+
+		if (this->isGridCompleted()) {
+			return ERR_NO_MORE_HYPOTHESIS;
+		}
+
+		if (threads_number == 0) {
+			threads_number = std::thread::hardware_concurrency();
+		}
+		if (threads_number == 0) {
+			threads_number = 1;
+		}
+
+		// Split the tree down to a depth giving a few tasks per thread, deeper sub trees are searched sequentially
+		size_t split_depth = 2;
+		for (size_t t = threads_number; t > 1; t /= 2) {
+			split_depth++;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		// The root task : the grid once the initial values are propagated
+		RegulareSquare root_grid = *this;
+		if (!root_grid.propagate(nullptr, this->statistics())) {
+			return ret;
+		}
+
+		// One solver per thread : it stores the solutions and counts the nodes (and statistics) of its thread
+		std::vector<RegulareSquare>                  solvers(threads_number, *this);
+		for (auto& solver : solvers) {
+			solver.resetStatistics();
+		}
+		std::vector< WorkStealingQueue<ParallelTask> > queues(threads_number);
+
+		std::atomic<size_t> pending_tasks(1);   // queued or running
+		std::atomic<size_t> queued_tasks(1);
+		std::atomic<bool>   cancel(false);
+
+		// Idle workers sleep until a task is queued or the search is over. The counters are changed before the
+		// mutex is taken to notify, so that a worker can't miss the wake up between its check and its wait
+		std::mutex              idle_mutex;
+		std::condition_variable idle_condition;
+		auto wake_idle_workers = [&]() {
+			{
+				std::lock_guard<std::mutex> lock(idle_mutex);
+			}
+			idle_condition.notify_all();
+		};
+
+		ParallelTask root_task;
+		root_grid.exportValues(root_task.Values);
+		root_task.Depth = 0;
+		queues[0].push(std::move(root_task));
+
+		auto worker = [&](size_t w) {
+			RegulareSquare& solver = solvers[w];
+			RegulareSquare  grid = *this;
+
+			SearchContext context;
+			context.SolutionsLimit = stop_on_first_solution ? 1 : 0;
+			context.SolutionsNumber = 0;
+			context.StoreSolutions = true;
+			context.Cancel = &cancel;
+			context.NodesLimit = 0;
+			context.RandomizeValues = false;
+			context.Visitor = nullptr;
+			context.Statistics = solver.statistics();
+			context.Depth = 0;
+
+			if (context.Statistics != nullptr) {
+				context.Statistics->GridCopiesNumber++;
+			}
+
+			std::vector<ParallelTask> children;
+
+			while (pending_tasks.load() > 0) {
+				ParallelTask task;
+
+				// Own tasks first (newest), then steal the oldest task of another thread
+				bool found = queues[w].pop(task);
+				for (size_t v = 1; (v < threads_number) && !found; v++) {
+					found = queues[(w + v) % threads_number].steal(task);
+				}
+
+				if (!found) {
+					std::unique_lock<std::mutex> lock(idle_mutex);
+					idle_condition.wait(lock, [&]() {
+						return (queued_tasks.load() > 0) || (pending_tasks.load() == 0);
+					});
+					continue;
+				}
+				queued_tasks--;
+
+				// After a cancellation the remaining tasks are only drained
+				if (!cancel.load()) {
+					children.clear();
+					solver.processParallelTask(grid, context, task, split_depth, children);
+
+					// Count the children before the task is done, so that pending_tasks can't reach 0 meanwhile
+					pending_tasks += children.size();
+					queued_tasks += children.size();
+					for (auto& child : children) {
+						queues[w].push(std::move(child));
+					}
+					if (!children.empty()) {
+						wake_idle_workers();
+					}
+
+					if (stop_on_first_solution && (context.SolutionsNumber > 0)) {
+						cancel = true;
+					}
+				}
+
+				if (--pending_tasks == 0) {
+					wake_idle_workers();
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (size_t w = 1; w < threads_number; w++) {
+			threads.emplace_back(worker, w);
+		}
+		worker(0);
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		// Merge the solutions and statistics of the threads
+		for (auto& solver : solvers) {
+			mSolutions.append(solver.mSolutions);
+			mSearchNodesNumber += solver.mSearchNodesNumber;
+			if (mStatisticsEnabled) {
+				this->addStatistics(solver.mStatistics);
+			}
+		}
+		if (mStatisticsEnabled) {
+			mStatistics.SearchesNumber++;
+			mStatistics.GridCopiesNumber += threads_number + 1;
+			mStatistics.SearchSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Several threads may have found a solution before the cancellation
+		if (stop_on_first_solution) {
+			mSolutions.truncate(1);
+		}
+
+		mSolved = !mSolutions.empty();
+
+		return ret;
+	}
+
+	void RegulareSquare::processParallelTask(RegulareSquare& grid,
+											 SearchContext& context,
+											 const ParallelTask& task,
+											 size_t split_depth,
+											 std::vector<ParallelTask>& children) {
+
+		context.Trail.clear();
+		context.Depth = task.Depth;
+
+		grid.loadValues(task.Values);
+		if (!grid.propagate(&context.Trail, context.Statistics)) {
+			return;
+		}
+
+		if (task.Depth >= split_depth) {
+			// Small enough : search the sub tree on this thread
+			this->recursiveSolveMRV(grid, context);
+			return;
+		}
+
+		size_t i = 0;
+		size_t j = 0;
+
+		if (!grid.selectMostConstrainedCell(i, j)) {
+			this->recordSolution(grid, context);
+			return;
+		}
+
+		// One child task per allowed value of the most constrained cell
+		for (ValueMask remaining_values = grid.mAllowedValuesMap[i][j]; remaining_values != 0; remaining_values = clearLowestValue(remaining_values)) {
+			const size_t V = lowestValue(remaining_values);
+
+			bool allowed = false;
+			grid.checkCandidate(i, j, V, allowed);
+
+			if (allowed) {
+				const size_t trail_mark = context.Trail.size();
+				grid.placeValue(i, j, V, &context.Trail);
+				mSearchNodesNumber++;
+				context.Depth++;
+
+				// The sub tree of the child is searched later : only a contradiction is a backtrack here
+				const bool consistent = grid.propagate(&context.Trail, context.Statistics);
+				if (consistent) {
+					ParallelTask child;
+					grid.exportValues(child.Values);
+					child.Depth = task.Depth + 1;
+					children.push_back(std::move(child));
+				}
+
+				countHypothesis(context, consistent);
+				context.Depth--;
+
+				grid.rewindTrail(context.Trail, trail_mark);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,198 @@
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PUZZLE_BANK_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "PuzzleBank.h"
+
+namespace MagicSquares {
+
+	namespace {
+
+		uint32_t readUint32(const unsigned char* bytes) {
+			return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+				   (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+		}
+
+		void writeUint32(unsigned char* bytes, uint32_t value) {
+			for (size_t b = 0; b < 4; b++) {
+				bytes[b] = static_cast<unsigned char>(value >> (8 * b));
+			}
+		}
+
+	}
+
+	PuzzleBank::PuzzleBank(const std::string& path) :
+			mData(nullptr),
+			mDataSize(0),
+			mMapped(false),
+			mRootSize(0),
+			mCellBits(0),
+			mRecordSize(0),
+			mPuzzlesNumber(0) {
+
+		if (this->mapFile(path)) {
+			mMapped = true;
+		} else {
+			// No mapping (other system...) : the whole file in memory
+			std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+			if (file.is_open()) {
+				mBuffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+				if (!mBuffer.empty()) {
+					mData = mBuffer.data();
+					mDataSize = mBuffer.size();
+				}
+			}
+		}
+
+		if (mData != nullptr) {
+			mRootSize = (mDataSize >= HEADER_SIZE) ? readHeader(mData) : 0;
+			if (mRootSize == 0) {
+				this->unmapFile();
+				mBuffer.clear();
+				mData = nullptr;
+				return;
+			}
+			mCellBits = bitsPerCell(mRootSize);
+			mRecordSize = recordSize(mRootSize);
+			mPuzzlesNumber = (mDataSize - HEADER_SIZE) / mRecordSize;
+		}
+	}
+
+	PuzzleBank::~PuzzleBank() {
+		this->unmapFile();
+	}
+
+	const char* PuzzleBank::magic() {
+		return "MSQBANK";
+	}
+
+	GridCell PuzzleBank::cell(size_t id, size_t k) const {
+		const unsigned char* cells = this->record(id) + RECORD_METADATA_SIZE;
+		const size_t cells_bytes = mRecordSize - RECORD_METADATA_SIZE;
+
+		// A cell (7 bits at most) is on one or two bytes
+		const size_t bit = k * mCellBits;
+		const size_t byte = bit / 8;
+		unsigned int word = cells[byte];
+		if (byte + 1 < cells_bytes) {
+			word |= static_cast<unsigned int>(cells[byte + 1]) << 8;
+		}
+		return static_cast<GridCell>((word >> (bit % 8)) & ((1u << mCellBits) - 1));
+	}
+
+	PuzzleBank::PuzzleMetadata PuzzleBank::metadata(size_t id) const {
+		const unsigned char* bytes = this->record(id);
+
+		PuzzleMetadata metadata;
+		metadata.HintsNumber = static_cast<size_t>(bytes[0]) | (static_cast<size_t>(bytes[1]) << 8);
+		metadata.Level = (bytes[2] <= RegulareSquare::DIFFICULTY_EXPERT) ? static_cast<RegulareSquare::DIFFICULTY_LEVEL>(bytes[2]) : RegulareSquare::DIFFICULTY_EXPERT;
+		metadata.SolutionsNumber = bytes[3];
+		metadata.Score = readUint32(bytes + 4);
+		return metadata;
+	}
+
+	void PuzzleBank::unpack(size_t id, GridCell* values) const {
+		const size_t cells_number = mRootSize * mRootSize * mRootSize * mRootSize;
+		for (size_t k = 0; k < cells_number; k++) {
+			values[k] = this->cell(id, k);
+		}
+	}
+
+	RegulareSquare::ERROR_CODE PuzzleBank::load(size_t id, RegulareSquare& grid) const {
+		if ((id >= mPuzzlesNumber) || (grid.getGridRootSize() != mRootSize)) {
+			return RegulareSquare::ERR_OUT_OF_GRIDS_BOUNDS;
+		}
+
+		GridCell values[RegulareSquare::MAX_GRID_ROOT_SIZE * RegulareSquare::MAX_GRID_ROOT_SIZE * RegulareSquare::MAX_GRID_ROOT_SIZE * RegulareSquare::MAX_GRID_ROOT_SIZE];
+		this->unpack(id, values);
+		return grid.fromValues(values);
+	}
+
+	size_t PuzzleBank::bitsPerCell(size_t root_size) {
+		const size_t max_value = root_size * root_size;
+		size_t bits = 1;
+		while ((size_t(1) << bits) <= max_value) {
+			bits++;
+		}
+		return bits;
+	}
+
+	size_t PuzzleBank::recordSize(size_t root_size) {
+		const size_t cells_number = root_size * root_size * root_size * root_size;
+		return RECORD_METADATA_SIZE + (cells_number * bitsPerCell(root_size) + 7) / 8;
+	}
+
+	void PuzzleBank::writeHeader(unsigned char* header, size_t root_size) {
+		memset(header, 0, HEADER_SIZE);
+		memcpy(header, magic(), 8);
+		writeUint32(header + 8, FORMAT_VERSION);
+		header[12] = static_cast<unsigned char>(root_size);
+		header[13] = static_cast<unsigned char>(bitsPerCell(root_size));
+		writeUint32(header + 16, static_cast<uint32_t>(recordSize(root_size)));
+	}
+
+	size_t PuzzleBank::readHeader(const unsigned char* header) {
+		const size_t root_size = header[12];
+		if ((memcmp(header, magic(), 8) != 0) || (readUint32(header + 8) != FORMAT_VERSION) ||
+			(root_size == 0) || (root_size > RegulareSquare::MAX_GRID_ROOT_SIZE) ||
+			(header[13] != bitsPerCell(root_size)) || (readUint32(header + 16) != recordSize(root_size))) {
+			return 0;
+		}
+		return root_size;
+	}
+
+#ifdef PUZZLE_BANK_MMAP
+
+	bool PuzzleBank::mapFile(const std::string& path) {
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+
+		struct stat file_status;
+		if ((fstat(fd, &file_status) != 0) || !S_ISREG(file_status.st_mode) || (file_status.st_size == 0)) {
+			close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+
+		// Puzzles are fetched by id, anywhere in the file
+		madvise(data, static_cast<size_t>(file_status.st_size), MADV_RANDOM);
+
+		mData = static_cast<const unsigned char*>(data);
+		mDataSize = static_cast<size_t>(file_status.st_size);
+		return true;
+	}
+
+	void PuzzleBank::unmapFile() {
+		if (mMapped && (mData != nullptr)) {
+			munmap(const_cast<unsigned char*>(mData), mDataSize);
+			mData = nullptr;
+			mMapped = false;
+		}
+	}
+
+#else
+
+	bool PuzzleBank::mapFile(const std::string&) {
+		return false;
+	}
+
+	void PuzzleBank::unmapFile() {
+	}
+
+#endif
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BasicSquare.h"
+#include "MagicSquare.h"
+
+namespace MagicSquares {
+
+	// Binary bank of puzzles of one root size, read in place : the file is memory mapped when the system
+	// allows it (read in memory otherwise), and any puzzle is found from its id without parsing.
+	//
+	// Layout (little endian) : a HEADER_SIZE bytes header, then fixed size records, puzzle id at
+	// HEADER_SIZE + id * record size (the stride is the index). A record holds the metadata of the puzzle
+	// (RECORD_METADATA_SIZE bytes) then its N * N cells, in the order of RegulareSquare::values(), packed on
+	// the fewest bits holding N (4 bits on 9 * 9, 5 up to 25 * 25...). The puzzles number comes from the file
+	// size : an interrupted write only loses its last record.
+	class PuzzleBank
+	{
+	public:
+
+		static const size_t HEADER_SIZE = 32;
+		static const size_t RECORD_METADATA_SIZE = 8;
+		static const uint32_t FORMAT_VERSION = 1;
+		static const size_t SOLUTIONS_UNKNOWN = 255;
+
+		// Magic bytes starting the file
+		static const char* magic();
+
+		typedef struct {
+			size_t                           HintsNumber;
+			RegulareSquare::DIFFICULTY_LEVEL Level;
+			size_t                           Score;             // DifficultyRating::Score
+			size_t                           SolutionsNumber;   // 0, 1, 2 for several, SOLUTIONS_UNKNOWN when not checked
+		} PuzzleMetadata;
+
+		explicit PuzzleBank(const std::string& path);
+
+		virtual ~PuzzleBank();
+
+		PuzzleBank(const PuzzleBank&) = delete;
+		PuzzleBank& operator=(const PuzzleBank&) = delete;
+
+		// False if the file is missing or is not a bank
+		bool isOpen() const {
+			return mData != nullptr;
+		};
+
+		bool isMapped() const {
+			return mMapped;
+		};
+
+		size_t getRootSize() const {
+			return mRootSize;
+		};
+
+		size_t size() const {
+			return mPuzzlesNumber;
+		};
+
+		// Record of the puzzle id, in the mapping (valid while the bank is open)
+		const unsigned char* record(size_t id) const {
+			return mData + HEADER_SIZE + id * mRecordSize;
+		};
+
+		// Value of the cell k (i * N + j) of the puzzle id, read in the record
+		GridCell cell(size_t id, size_t k) const;
+
+		PuzzleMetadata metadata(size_t id) const;
+
+		// N * N values of the puzzle id
+		void unpack(size_t id, GridCell* values) const;
+
+		// Puzzle id in a grid of the bank root size
+		RegulareSquare::ERROR_CODE load(size_t id, RegulareSquare& grid) const;
+
+		// Bits of a cell and bytes of a record for a root size
+		static size_t bitsPerCell(size_t root_size);
+
+		static size_t recordSize(size_t root_size);
+
+		// Header of a bank of root_size grids (HEADER_SIZE bytes)
+		static void writeHeader(unsigned char* header, size_t root_size);
+
+		// Root size of a bank header, 0 if it is not a header of this format
+		static size_t readHeader(const unsigned char* header);
+
+	private:
+
+		const unsigned char*       mData;
+		size_t                     mDataSize;
+		bool                       mMapped;
+		std::vector<unsigned char> mBuffer;   // file content when it can't be mapped
+
+		size_t mRootSize;
+		size_t mCellBits;
+		size_t mRecordSize;
+		size_t mPuzzlesNumber;
+
+		bool mapFile(const std::string& path);
+
+		void unmapFile();
+
+	};
+
+}
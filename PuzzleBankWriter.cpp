@@ -0,0 +1,81 @@
+#include <cstring>
+
+#include "PuzzleBankWriter.h"
+
+namespace MagicSquares {
+
+	PuzzleBankWriter::PuzzleBankWriter(const std::string& path, size_t root_size) :
+			mRootSize(root_size),
+			mPuzzlesNumber(0),
+			mRecord(PuzzleBank::recordSize(root_size), 0) {
+
+		unsigned char header[PuzzleBank::HEADER_SIZE];
+
+		// An existing bank is completed : same header, whole records only. Any other existing file is left
+		// untouched, unless it is empty
+		std::ifstream existing(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+		if (existing.is_open() && (existing.tellg() != 0)) {
+			const size_t file_size = static_cast<size_t>(existing.tellg());
+			existing.seekg(0, std::ios::beg);
+			if (!existing.read(reinterpret_cast<char*>(header), PuzzleBank::HEADER_SIZE) || (PuzzleBank::readHeader(header) != root_size)) {
+				return;
+			}
+			mPuzzlesNumber = (file_size - PuzzleBank::HEADER_SIZE) / mRecord.size();
+			existing.close();
+
+			mFile.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+			mFile.seekp(PuzzleBank::HEADER_SIZE + mPuzzlesNumber * mRecord.size());
+			return;
+		}
+		existing.close();
+
+		mFile.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (mFile.is_open()) {
+			PuzzleBank::writeHeader(header, root_size);
+			mFile.write(reinterpret_cast<const char*>(header), PuzzleBank::HEADER_SIZE);
+		}
+	}
+
+	PuzzleBankWriter::~PuzzleBankWriter() {
+		// Something to do ?
+	}
+
+	size_t PuzzleBankWriter::append(const GridCell* values, const PuzzleBank::PuzzleMetadata& metadata) {
+		unsigned char* record = mRecord.data();
+		memset(record, 0, mRecord.size());
+
+		record[0] = static_cast<unsigned char>(metadata.HintsNumber);
+		record[1] = static_cast<unsigned char>(metadata.HintsNumber >> 8);
+		record[2] = static_cast<unsigned char>(metadata.Level);
+		record[3] = static_cast<unsigned char>((metadata.SolutionsNumber < PuzzleBank::SOLUTIONS_UNKNOWN) ? metadata.SolutionsNumber : PuzzleBank::SOLUTIONS_UNKNOWN);
+		for (size_t b = 0; b < 4; b++) {
+			record[4 + b] = static_cast<unsigned char>(metadata.Score >> (8 * b));
+		}
+
+		// Cells packed from the lowest bit of each byte
+		unsigned char* cells = record + PuzzleBank::RECORD_METADATA_SIZE;
+		const size_t cell_bits = PuzzleBank::bitsPerCell(mRootSize);
+		const size_t cells_number = mRootSize * mRootSize * mRootSize * mRootSize;
+		for (size_t k = 0; k < cells_number; k++) {
+			const size_t bit = k * cell_bits;
+			const unsigned int word = static_cast<unsigned int>(values[k]) << (bit % 8);
+			cells[bit / 8] |= static_cast<unsigned char>(word);
+			if ((word >> 8) != 0) {
+				cells[bit / 8 + 1] |= static_cast<unsigned char>(word >> 8);
+			}
+		}
+
+		mFile.write(reinterpret_cast<const char*>(record), mRecord.size());
+		return mPuzzlesNumber++;
+	}
+
+	size_t PuzzleBankWriter::append(const RegulareSquare& puzzle) {
+		PuzzleBank::PuzzleMetadata metadata;
+		metadata.HintsNumber = puzzle.getGridHintsNumber();
+		metadata.Level = puzzle.getGridDifficulty().Level;
+		metadata.Score = puzzle.getGridDifficulty().Score;
+		metadata.SolutionsNumber = 1;
+		return this->append(puzzle.values(), metadata);
+	}
+
+}
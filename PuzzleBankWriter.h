@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "MagicSquare.h"
+#include "PuzzleBank.h"
+
+namespace MagicSquares {
+
+	// Appends puzzles to a PuzzleBank file : a new (or empty) file is created with its header, an existing bank
+	// of the same root size is completed. Any other existing file is refused, never truncated.
+	class PuzzleBankWriter
+	{
+	public:
+
+		PuzzleBankWriter(const std::string& path, size_t root_size);
+
+		virtual ~PuzzleBankWriter();
+
+		PuzzleBankWriter(const PuzzleBankWriter&) = delete;
+		PuzzleBankWriter& operator=(const PuzzleBankWriter&) = delete;
+
+		// False if the file can't be written, or holds another root size or format
+		bool isOpen() const {
+			return mFile.is_open();
+		};
+
+		// Puzzles in the bank, the previous ones included
+		size_t size() const {
+			return mPuzzlesNumber;
+		};
+
+		// Append the N * N values of a puzzle (order of RegulareSquare::values()), returns its id
+		size_t append(const GridCell* values, const PuzzleBank::PuzzleMetadata& metadata);
+
+		// Append a puzzle built by completeGridWithHints : its hints and difficulty, and a unique solution
+		size_t append(const RegulareSquare& puzzle);
+
+		void flush() {
+			mFile.flush();
+		};
+
+	private:
+
+		std::ofstream              mFile;
+		size_t                     mRootSize;
+		size_t                     mPuzzlesNumber;
+		std::vector<unsigned char> mRecord;
+
+	};
+
+}
@@ -0,0 +1,161 @@
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "CanonicalForm.h"
+#include "PuzzleBatchGenerator.h"
+
+namespace MagicSquares {
+
+	PuzzleBatchGenerator::PuzzleBatchGenerator(size_t grid_root_size, size_t threads_number) :
+			mGridRootSize(grid_root_size),
+			mThreadsNumber(threads_number),
+			mSeed((static_cast<uint64_t>(std::random_device()()) << 32) ^ std::random_device()()),
+			mGenerationMaxSeconds(0.0),
+			mGenerationMaxChecks(0),
+			mDifficultyMin(RegulareSquare::DIFFICULTY_EASY),
+			mDifficultyMax(RegulareSquare::DIFFICULTY_EXPERT),
+			mClueSymmetry(RegulareSquare::SYMMETRY_NONE),
+			mDeduplicationIndex(nullptr),
+			mDeduplicationMode(DEDUP_NONE),
+			mDuplicatesNumber(0) {
+
+		if (mThreadsNumber == 0) {
+			mThreadsNumber = std::thread::hardware_concurrency();
+		}
+		if (mThreadsNumber == 0) {
+			mThreadsNumber = 1;
+		}
+	}
+
+	PuzzleBatchGenerator::~PuzzleBatchGenerator() {
+		// Something to do ?
+	}
+
+	size_t PuzzleBatchGenerator::generate(size_t puzzles_number, size_t hints_number, const PuzzleSink& sink) {
+
+		std::atomic<size_t> next_puzzle(0);
+		std::mutex          mutex;
+		size_t              sent_puzzles = 0;
+
+		// Deduplication : the completed puzzles wait here for the ones before them. A single worker at a time
+		// checks them against the index, in the index order, so that the duplicates do not depend on the timing
+		std::map<size_t, PendingPuzzle> pending_puzzles;
+		size_t next_checked = 0;
+		bool   checking = false;
+
+		mDuplicatesNumber = 0;
+
+		// Check of a puzzle against the index, generated again while it is a duplicate : its slot holds the
+		// next ones back meanwhile, the other workers go on with the next indexes
+		auto checkPuzzle = [&](size_t puzzle_index, PendingPuzzle& pending) {
+			while ((pending.Ret == RegulareSquare::ERR_OK) && !mDeduplicationIndex->insert(pending.Key)) {
+				mDuplicatesNumber++;
+				if (pending.Attempt >= MAX_DUPLICATE_RETRIES) {
+					pending.Ret = RegulareSquare::ERR_UNABLE_TO_FILL_HINTS;
+					break;
+				}
+				pending = this->generatePuzzle(puzzle_index, pending.Attempt + 1, hints_number);
+			}
+		};
+
+		auto worker = [&]() {
+			// Each worker takes the next puzzle index until the batch is exhausted
+			for (size_t puzzle_index = next_puzzle++; puzzle_index < puzzles_number; puzzle_index = next_puzzle++) {
+				PendingPuzzle completed = this->generatePuzzle(puzzle_index, 0, hints_number);
+
+				std::unique_lock<std::mutex> lock(mutex);
+				if (mDeduplicationMode == DEDUP_NONE) {
+					if (completed.Ret == RegulareSquare::ERR_OK) {
+						sink(puzzle_index, completed.Puzzle);
+						sent_puzzles++;
+					}
+					continue;
+				}
+
+				// The worker completing the next puzzle to check checks it, and the following ones already there
+				pending_puzzles.emplace(puzzle_index, std::move(completed));
+				while (!checking && !pending_puzzles.empty() && (pending_puzzles.begin()->first == next_checked)) {
+					PendingPuzzle pending = std::move(pending_puzzles.begin()->second);
+					pending_puzzles.erase(pending_puzzles.begin());
+					checking = true;
+					lock.unlock();
+
+					checkPuzzle(next_checked, pending);
+					if (pending.Ret == RegulareSquare::ERR_OK) {
+						sink(next_checked, pending.Puzzle);
+					}
+
+					lock.lock();
+					if (pending.Ret == RegulareSquare::ERR_OK) {
+						sent_puzzles++;
+					}
+					next_checked++;
+					checking = false;
+				}
+			}
+		};
+
+		const size_t workers_number = (mThreadsNumber < puzzles_number) ? mThreadsNumber : puzzles_number;
+
+		std::vector<std::thread> workers;
+		for (size_t t = 1; t < workers_number; t++) {
+			workers.emplace_back(worker);
+		}
+
+		// The calling thread is one of the workers
+		if (workers_number > 0) {
+			worker();
+		}
+
+		for (auto& thread : workers) {
+			thread.join();
+		}
+
+		return sent_puzzles;
+	}
+
+	PuzzleBatchGenerator::PendingPuzzle PuzzleBatchGenerator::generatePuzzle(size_t puzzle_index, size_t attempt, size_t hints_number) {
+		PendingPuzzle pending = { RegulareSquare::ERR_OK, attempt, 0, RegulareSquare(mGridRootSize) };
+		pending.Puzzle.setRandomSeed(puzzleSeed(mSeed, puzzle_index, attempt));
+		this->configure(pending.Puzzle);
+
+		// Every solved grid is accepted : the last one is the grid of the puzzle, checked in the index order
+		uint64_t solved_grid_key = 0;
+		if (mDeduplicationMode == DEDUP_SOLVED_GRIDS) {
+			pending.Puzzle.setSolvedGridFilter([&solved_grid_key](const RegulareSquare& solved_grid) {
+				solved_grid_key = CanonicalForm::hashOf(solved_grid);
+				return true;
+			});
+		}
+
+		pending.Ret = pending.Puzzle.completeGridWithHints(hints_number);
+
+		if (mDeduplicationMode == DEDUP_SOLVED_GRIDS) {
+			pending.Puzzle.setSolvedGridFilter(RegulareSquare::SolvedGridFilter());
+			pending.Key = solved_grid_key;
+		} else if ((mDeduplicationMode == DEDUP_PUZZLES) && (pending.Ret == RegulareSquare::ERR_OK)) {
+			pending.Key = CanonicalForm::hashOf(pending.Puzzle);
+		}
+		return pending;
+	}
+
+	void PuzzleBatchGenerator::configure(RegulareSquare& puzzle) {
+		puzzle.setVerbose(false);
+		puzzle.setGenerationBudget(mGenerationMaxSeconds, mGenerationMaxChecks);
+		puzzle.setDifficultyBand(mDifficultyMin, mDifficultyMax);
+		puzzle.setClueSymmetry(mClueSymmetry);
+		puzzle.setClueMask(mClueMask);
+	}
+
+	uint64_t PuzzleBatchGenerator::puzzleSeed(uint64_t batch_seed, size_t puzzle_index, size_t attempt) {
+		// Close indexes and attempts give unrelated seeds (the first attempt keeps the seed of the index)
+		uint64_t state = batch_seed ^ (static_cast<uint64_t>(puzzle_index) * 0xD1B54A32D192ED03ULL) ^
+						 (static_cast<uint64_t>(attempt) * 0xA0761D6478BD642FULL);
+		return RandomGenerator::splitMix64(state);
+	}
+
+}
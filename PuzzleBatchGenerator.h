@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "CanonicalIndex.h"
+#include "MagicSquare.h"
+
+namespace MagicSquares {
+
+	// Generates batches of puzzles with completeGridWithHints on a pool of worker threads.
+	// Each puzzle has its own random generator, seeded from the batch seed and the puzzle index :
+	// a given seed always gives the same puzzles, whatever the threads number. With a deduplication too : the
+	// puzzles are checked against the index in their index order, and a duplicate is generated again from the
+	// seed of its next attempt (for the same index content before the batch).
+	class PuzzleBatchGenerator
+	{
+	public:
+
+		// What is checked against the canonical forms index
+		enum DEDUPLICATION_MODE {
+			DEDUP_NONE = 0,
+			DEDUP_SOLVED_GRIDS,   // puzzles of a solved grid equivalent to a previous one are generated again (new seed)
+			DEDUP_PUZZLES         // puzzles equivalent to a previous one are generated again (new seed)
+		};
+
+		// Receives each puzzle as soon as it is completed (completion order), one call at a time.
+		// With a deduplication, as soon as the puzzles before it are checked (index order)
+		typedef std::function<void(size_t puzzle_index, const RegulareSquare& puzzle)> PuzzleSink;
+
+		// threads_number 0 : one worker per hardware thread
+		PuzzleBatchGenerator(size_t grid_root_size, size_t threads_number = 0);
+
+		virtual ~PuzzleBatchGenerator();
+
+		void setSeed(uint64_t seed) {
+			mSeed = seed;
+		};
+
+		uint64_t getSeed() const {
+			return mSeed;
+		};
+
+		// Budget of each puzzle (see RegulareSquare::setGenerationBudget) : the puzzles out of budget are not sent
+		void setGenerationBudget(double max_seconds, size_t max_uniqueness_checks) {
+			mGenerationMaxSeconds = max_seconds;
+			mGenerationMaxChecks = max_uniqueness_checks;
+		};
+
+		// Difficulty band of each puzzle (see RegulareSquare::setDifficultyBand)
+		void setDifficultyBand(RegulareSquare::DIFFICULTY_LEVEL min_level, RegulareSquare::DIFFICULTY_LEVEL max_level) {
+			mDifficultyMin = min_level;
+			mDifficultyMax = max_level;
+		};
+
+		// Clues layout of each puzzle (see RegulareSquare::setClueSymmetry and setClueMask)
+		void setClueSymmetry(RegulareSquare::CLUE_SYMMETRY symmetry) {
+			mClueSymmetry = symmetry;
+		};
+
+		void setClueMask(const std::vector<bool>& clue_cells) {
+			mClueMask = clue_cells;
+		};
+
+		// Index of the batch (it may come from a previous batch, see CanonicalIndex::open), null for none.
+		// A puzzle is generated again at most MAX_DUPLICATE_RETRIES times.
+		void setDeduplication(CanonicalIndex* index, DEDUPLICATION_MODE mode) {
+			mDeduplicationIndex = index;
+			mDeduplicationMode = (index != nullptr) ? mode : DEDUP_NONE;
+		};
+
+		static const size_t MAX_DUPLICATE_RETRIES = 16;
+
+		// Duplicates rejected by the last generate
+		size_t getDuplicatesNumber() const {
+			return mDuplicatesNumber;
+		};
+
+		size_t getThreadsNumber() const {
+			return mThreadsNumber;
+		};
+
+		// Generate puzzles_number puzzles of hints_number hints, returns the number of puzzles sent to the sink
+		size_t generate(size_t puzzles_number, size_t hints_number, const PuzzleSink& sink);
+
+		// Seed of the puzzle puzzle_index of a batch, for its attempt attempt (0, then 1 for its first duplicate...)
+		static uint64_t puzzleSeed(uint64_t batch_seed, size_t puzzle_index, size_t attempt = 0);
+
+	private:
+
+		size_t   mGridRootSize;
+		size_t   mThreadsNumber;
+		uint64_t mSeed;
+		double   mGenerationMaxSeconds;
+		size_t   mGenerationMaxChecks;
+
+		RegulareSquare::DIFFICULTY_LEVEL mDifficultyMin;
+		RegulareSquare::DIFFICULTY_LEVEL mDifficultyMax;
+
+		RegulareSquare::CLUE_SYMMETRY mClueSymmetry;
+		std::vector<bool>             mClueMask;
+
+		CanonicalIndex*     mDeduplicationIndex;
+		DEDUPLICATION_MODE  mDeduplicationMode;
+		std::atomic<size_t> mDuplicatesNumber;
+
+		// A puzzle completed, waiting for its turn to be checked against the index
+		typedef struct {
+			RegulareSquare::ERROR_CODE Ret;
+			size_t                     Attempt;
+			uint64_t                   Key;      // canonical form hash of the puzzle, or of its solved grid
+			RegulareSquare             Puzzle;
+		} PendingPuzzle;
+
+		// Settings of the batch given to a puzzle
+		void configure(RegulareSquare& puzzle);
+
+		PendingPuzzle generatePuzzle(size_t puzzle_index, size_t attempt, size_t hints_number);
+
+	};
+
+}
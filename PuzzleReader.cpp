@@ -0,0 +1,159 @@
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PUZZLE_READER_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MagicSquare.h"
+#include "PuzzleReader.h"
+
+namespace MagicSquares {
+
+	PuzzleReader::PuzzleReader(std::istream& input) :
+			mOpen(true),
+			mInput(&input),
+			mMappedData(nullptr),
+			mMappedSize(0),
+			mMappedOffset(0) {
+	}
+
+	PuzzleReader::PuzzleReader(const std::string& path) :
+			mOpen(false),
+			mInput(nullptr),
+			mMappedData(nullptr),
+			mMappedSize(0),
+			mMappedOffset(0) {
+
+		if (path == "-") {
+			mInput = &std::cin;
+			mOpen = true;
+		} else if (this->mapFile(path)) {
+			mOpen = true;
+		} else {
+			// No mapping (empty file, pipe, other system...) : stream the file
+			mFile.open(path.c_str(), std::ios::in | std::ios::binary);
+			mInput = &mFile;
+			mOpen = mFile.is_open();
+		}
+	}
+
+	PuzzleReader::~PuzzleReader() {
+		this->unmapFile();
+	}
+
+	bool PuzzleReader::nextPuzzle(const char*& puzzle, size_t& length) {
+		while (this->nextLine(puzzle, length)) {
+			findPuzzle(puzzle, length);
+			if (length > 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool PuzzleReader::nextLine(const char*& line, size_t& length) {
+		if (mMappedData != nullptr) {
+			if (mMappedOffset >= mMappedSize) {
+				return false;
+			}
+			line = mMappedData + mMappedOffset;
+			const char* end = static_cast<const char*>(memchr(line, '\n', mMappedSize - mMappedOffset));
+			length = (end != nullptr) ? static_cast<size_t>(end - line) : (mMappedSize - mMappedOffset);
+			mMappedOffset += length + 1;
+		} else {
+			if ((mInput == nullptr) || !std::getline(*mInput, mLineBuffer)) {
+				return false;
+			}
+			line = mLineBuffer.data();
+			length = mLineBuffer.size();
+		}
+
+		// Windows end of line
+		if ((length > 0) && (line[length - 1] == '\r')) {
+			length--;
+		}
+		return true;
+	}
+
+	void PuzzleReader::findPuzzle(const char*& line, size_t& length) {
+		const char* end = line + length;
+		const char* field = line;
+
+		while (field < end) {
+			while ((field < end) && ((*field == ' ') || (*field == '\t') || (*field == ',') || (*field == ';'))) {
+				field++;
+			}
+			if ((field < end) && (*field == '#')) {
+				break;
+			}
+
+			const char* field_end = field;
+			while ((field_end < end) && (*field_end != ' ') && (*field_end != '\t') && (*field_end != ',') && (*field_end != ';')) {
+				field_end++;
+			}
+
+			const size_t field_length = static_cast<size_t>(field_end - field);
+			if ((field_length > 1) && (RegulareSquare::rootSizeOfLine(field_length) != 0)) {
+				line = field;
+				length = field_length;
+				return;
+			}
+			field = field_end;
+		}
+
+		length = 0;
+	}
+
+#ifdef PUZZLE_READER_MMAP
+
+	bool PuzzleReader::mapFile(const std::string& path) {
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+
+		struct stat file_status;
+		if ((fstat(fd, &file_status) != 0) || !S_ISREG(file_status.st_mode) || (file_status.st_size == 0)) {
+			close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+
+		// One pass from the beginning to the end
+		madvise(data, static_cast<size_t>(file_status.st_size), MADV_SEQUENTIAL);
+
+		mMappedData = static_cast<const char*>(data);
+		mMappedSize = static_cast<size_t>(file_status.st_size);
+		mMappedOffset = 0;
+		return true;
+	}
+
+	void PuzzleReader::unmapFile() {
+		if (mMappedData != nullptr) {
+			munmap(const_cast<char*>(mMappedData), mMappedSize);
+			mMappedData = nullptr;
+		}
+	}
+
+#else
+
+	bool PuzzleReader::mapFile(const std::string&) {
+		return false;
+	}
+
+	void PuzzleReader::unmapFile() {
+	}
+
+#endif
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <string>
+
+namespace MagicSquares {
+
+	// Reads puzzles one line at a time, from a stream (stdin) or from a file.
+	// A file is memory mapped when the system allows it : lines are read in place, without copy.
+	// Blank lines and lines starting with '#' are skipped. When a line has several fields
+	// ("index puzzle" as written by the batch generator), the first one with a grid length is the puzzle.
+	class PuzzleReader
+	{
+	public:
+
+		// Read from an open stream (the stream must outlive the reader)
+		explicit PuzzleReader(std::istream& input);
+
+		// Read from a file, "-" for stdin
+		explicit PuzzleReader(const std::string& path);
+
+		virtual ~PuzzleReader();
+
+		PuzzleReader(const PuzzleReader&) = delete;
+		PuzzleReader& operator=(const PuzzleReader&) = delete;
+
+		bool isOpen() const {
+			return mOpen;
+		};
+
+		bool isMapped() const {
+			return mMappedData != nullptr;
+		};
+
+		// Next puzzle : valid until the next call. Returns false at the end of the input.
+		bool nextPuzzle(const char*& puzzle, size_t& length);
+
+	private:
+
+		bool           mOpen;
+		std::istream*  mInput;
+		std::ifstream  mFile;
+		std::string    mLineBuffer;
+
+		const char*    mMappedData;
+		size_t         mMappedSize;
+		size_t         mMappedOffset;
+
+		bool nextLine(const char*& line, size_t& length);
+
+		bool mapFile(const std::string& path);
+
+		void unmapFile();
+
+		// The puzzle field of a line (length 0 for a blank or comment line)
+		static void findPuzzle(const char*& line, size_t& length);
+
+	};
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MagicSquares {
+
+	// xoshiro256** pseudo random generator (Blackman & Vigna) : 32 bytes of state, no lock, no global state.
+	// Satisfies the UniformRandomBitGenerator requirements, so it can also feed the <random> distributions.
+	class RandomGenerator
+	{
+	public:
+
+		typedef uint64_t result_type;
+
+		explicit RandomGenerator(uint64_t seed = 0) {
+			this->seed(seed);
+		};
+
+		// The state is expanded from the seed with SplitMix64, as advised by the xoshiro authors
+		void seed(uint64_t seed) {
+			uint64_t splitmix_state = seed;
+			for (size_t k = 0; k < 4; k++) {
+				mState[k] = splitMix64(splitmix_state);
+			}
+		};
+
+		static constexpr result_type min() {
+			return 0;
+		};
+
+		static constexpr result_type max() {
+			return ~result_type(0);
+		};
+
+		result_type operator()() {
+			const uint64_t result = rotateLeft(mState[1] * 5, 7) * 9;
+			const uint64_t t = mState[1] << 17;
+
+			mState[2] ^= mState[0];
+			mState[3] ^= mState[1];
+			mState[1] ^= mState[2];
+			mState[0] ^= mState[3];
+
+			mState[2] ^= t;
+			mState[3] = rotateLeft(mState[3], 45);
+
+			return result;
+		};
+
+		// Uniform integer in [0, n) (n > 0), without the modulo bias
+		size_t uniform(size_t n) {
+			const uint64_t bound = static_cast<uint64_t>(n);
+			const uint64_t threshold = (0 - bound) % bound;
+			uint64_t r = (*this)();
+			while (r < threshold) {
+				r = (*this)();
+			}
+			return static_cast<size_t>(r % bound);
+		};
+
+		// Advance the generator by 2^128 steps : successive jumps give non overlapping sequences
+		void jump() {
+			static const uint64_t JUMP[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+			uint64_t s[4] = { 0, 0, 0, 0 };
+			for (size_t k = 0; k < 4; k++) {
+				for (size_t b = 0; b < 64; b++) {
+					if (JUMP[k] & (uint64_t(1) << b)) {
+						for (size_t l = 0; l < 4; l++) {
+							s[l] ^= mState[l];
+						}
+					}
+					(*this)();
+				}
+			}
+			for (size_t l = 0; l < 4; l++) {
+				mState[l] = s[l];
+			}
+		};
+
+		// One SplitMix64 step : turns close values (seed, index...) into unrelated ones
+		static uint64_t splitMix64(uint64_t& state) {
+			uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		};
+
+	private:
+
+		uint64_t mState[4];
+
+		static uint64_t rotateLeft(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		};
+
+	};
+
+}
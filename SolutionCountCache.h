@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MagicSquares {
+
+	// Uniqueness verdicts of the grids already searched, keyed on the grid hash (see RegulareSquare::getGridHash).
+	// Bounded : past the capacity, the least recently used grid is evicted.
+	// Fixed size open addressing table (linear probing, load factor up to 1/2) with the LRU list linked through
+	// the slots : nothing is allocated after reset. Not thread safe (one per thread, reset for each generation).
+	class SolutionCountCache
+	{
+	public:
+
+		enum SOLUTIONS_VERDICT {
+			UNIQUE_SOLUTION = 0,
+			MULTIPLE_SOLUTIONS
+		};
+
+		SolutionCountCache() :
+				mCapacity(0),
+				mSize(0),
+				mSlotsMask(0),
+				mGeneration(1),
+				mHead(NO_SLOT),
+				mTail(NO_SLOT),
+				mHitsNumber(0),
+				mMissesNumber(0),
+				mEvictionsNumber(0) {
+		};
+
+		// Empty the cache, for up to capacity grids (0 : nothing is remembered). The table is only allocated again
+		// when the capacity changes, otherwise a new generation frees all the slots at once
+		void reset(size_t capacity) {
+			if (capacity != mCapacity) {
+				size_t slots_number = 1;
+				while (slots_number < 2 * capacity) {
+					slots_number <<= 1;
+				}
+				mCapacity = capacity;
+				mSlots.assign((capacity != 0) ? slots_number : 0, Slot());
+				mSlotsMask = slots_number - 1;
+				mGeneration = 0;
+			}
+
+			// Generation 0 marks the free slots : on wrap around, the stale ones must be freed for real
+			if (++mGeneration == 0) {
+				std::fill(mSlots.begin(), mSlots.end(), Slot());
+				mGeneration = 1;
+			}
+
+			mSize = 0;
+			mHead = NO_SLOT;
+			mTail = NO_SLOT;
+			mHitsNumber = 0;
+			mMissesNumber = 0;
+			mEvictionsNumber = 0;
+		};
+
+		// False if the grid is unknown
+		bool find(uint64_t grid_hash, SOLUTIONS_VERDICT& verdict) {
+			const size_t s = this->lookup(grid_hash);
+			if (s == NO_SLOT) {
+				mMissesNumber++;
+				return false;
+			}
+			mHitsNumber++;
+
+			// Most recently used first
+			this->unlink(s);
+			this->pushFront(s);
+			verdict = mSlots[s].Verdict;
+			return true;
+		};
+
+		void insert(uint64_t grid_hash, SOLUTIONS_VERDICT verdict) {
+			if (mCapacity == 0) {
+				return;
+			}
+
+			size_t s = this->lookup(grid_hash);
+			if (s != NO_SLOT) {
+				mSlots[s].Verdict = verdict;
+				this->unlink(s);
+				this->pushFront(s);
+				return;
+			}
+
+			if (mSize >= mCapacity) {
+				this->erase(mTail);
+				mEvictionsNumber++;
+			}
+
+			// Never full : the load factor stays under 1/2
+			for (s = grid_hash & mSlotsMask; this->isUsed(s); s = (s + 1) & mSlotsMask) {
+			}
+			mSlots[s].Hash = grid_hash;
+			mSlots[s].Generation = mGeneration;
+			mSlots[s].Verdict = verdict;
+			this->pushFront(s);
+			mSize++;
+		};
+
+		size_t size() const {
+			return mSize;
+		};
+
+		size_t getCapacity() const {
+			return mCapacity;
+		};
+
+		size_t getHitsNumber() const {
+			return mHitsNumber;
+		};
+
+		size_t getMissesNumber() const {
+			return mMissesNumber;
+		};
+
+		size_t getEvictionsNumber() const {
+			return mEvictionsNumber;
+		};
+
+	private:
+
+		typedef struct {
+			uint64_t          Hash;
+			uint32_t          Generation;   // used slot when equal to the cache generation
+			uint32_t          Previous;     // LRU list (slots indexes), most recently used first
+			uint32_t          Next;
+			SOLUTIONS_VERDICT Verdict;
+		} Slot;
+
+		static const uint32_t NO_SLOT = UINT32_MAX;
+
+		bool isUsed(size_t s) const {
+			return mSlots[s].Generation == mGeneration;
+		};
+
+		size_t lookup(uint64_t grid_hash) const {
+			if (mCapacity == 0) {
+				return NO_SLOT;
+			}
+			for (size_t s = grid_hash & mSlotsMask; this->isUsed(s); s = (s + 1) & mSlotsMask) {
+				if (mSlots[s].Hash == grid_hash) {
+					return s;
+				}
+			}
+			return NO_SLOT;
+		};
+
+		void unlink(size_t s) {
+			const uint32_t previous = mSlots[s].Previous;
+			const uint32_t next = mSlots[s].Next;
+			if (previous != NO_SLOT) {
+				mSlots[previous].Next = next;
+			} else {
+				mHead = next;
+			}
+			if (next != NO_SLOT) {
+				mSlots[next].Previous = previous;
+			} else {
+				mTail = previous;
+			}
+		};
+
+		void pushFront(size_t s) {
+			mSlots[s].Previous = NO_SLOT;
+			mSlots[s].Next = mHead;
+			if (mHead != NO_SLOT) {
+				mSlots[mHead].Previous = static_cast<uint32_t>(s);
+			} else {
+				mTail = static_cast<uint32_t>(s);
+			}
+			mHead = static_cast<uint32_t>(s);
+		};
+
+		// Backward shift deletion : the following slots of the probe sequence fill the hole, no tombstones
+		void erase(size_t hole) {
+			this->unlink(hole);
+			for (size_t s = (hole + 1) & mSlotsMask; this->isUsed(s); s = (s + 1) & mSlotsMask) {
+				// The grid of slot s can move to the hole if the hole is between its home slot and s
+				const size_t home = mSlots[s].Hash & mSlotsMask;
+				if (((s - home) & mSlotsMask) >= ((s - hole) & mSlotsMask)) {
+					this->move(s, hole);
+					hole = s;
+				}
+			}
+			mSlots[hole].Generation = 0;
+			mSize--;
+		};
+
+		void move(size_t from, size_t to) {
+			mSlots[to] = mSlots[from];
+			const uint32_t previous = mSlots[to].Previous;
+			const uint32_t next = mSlots[to].Next;
+			if (previous != NO_SLOT) {
+				mSlots[previous].Next = static_cast<uint32_t>(to);
+			} else {
+				mHead = static_cast<uint32_t>(to);
+			}
+			if (next != NO_SLOT) {
+				mSlots[next].Previous = static_cast<uint32_t>(to);
+			} else {
+				mTail = static_cast<uint32_t>(to);
+			}
+		};
+
+		std::vector<Slot> mSlots;
+		size_t            mCapacity;
+		size_t            mSize;
+		size_t            mSlotsMask;
+		uint32_t          mGeneration;
+		uint32_t          mHead;   // most recently used
+		uint32_t          mTail;   // least recently used, evicted first
+
+		size_t mHitsNumber;
+		size_t mMissesNumber;
+		size_t mEvictionsNumber;
+
+	};
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "BasicSquare.h"
+
+namespace MagicSquares {
+
+	// Solutions of a grid packed one after the other in a single contiguous block :
+	// N * N GridCell values per solution (cell i,j at i * N + j), nothing else.
+	class SolutionStore
+	{
+	public:
+
+		explicit SolutionStore(size_t cells_number = 0) :
+				mCellsNumber(cells_number) {
+		};
+
+		size_t getCellsNumber() const {
+			return mCellsNumber;
+		};
+
+		size_t size() const {
+			return (mCellsNumber == 0) ? 0 : mValues.size() / mCellsNumber;
+		};
+
+		bool empty() const {
+			return mValues.empty();
+		};
+
+		void clear() {
+			mValues.clear();
+		};
+
+		// Keep the first solutions_number solutions only
+		void truncate(size_t solutions_number) {
+			if (solutions_number < this->size()) {
+				mValues.resize(solutions_number * mCellsNumber);
+			}
+		};
+
+		void reserve(size_t solutions_number) {
+			mValues.reserve(solutions_number * mCellsNumber);
+		};
+
+		void add(const GridCell* values) {
+			mValues.insert(mValues.end(), values, values + mCellsNumber);
+		};
+
+		void append(const SolutionStore& other) {
+			mValues.insert(mValues.end(), other.mValues.begin(), other.mValues.end());
+		};
+
+		// Values of the solution k
+		const GridCell* operator[](size_t k) const {
+			return mValues.data() + k * mCellsNumber;
+		};
+
+		// Memory used by the values
+		size_t bytesNumber() const {
+			return mValues.capacity() * sizeof(GridCell);
+		};
+
+	private:
+
+		size_t                mCellsNumber;
+		std::vector<GridCell> mValues;
+
+	};
+
+}
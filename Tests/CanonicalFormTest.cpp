@@ -0,0 +1,176 @@
+// CanonicalForm : every grid obtained by valid transformations has the same form. Up to FULL_SEARCH_MAX_ROOT_SIZE
+// the whole group is covered (relabeling, transposition, bands / stacks permutations, lines / columns permutations
+// in a band / stack), above only the relabeling and the transposition. Solved grids and grids with void cells.
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "CanonicalForm.h"
+#include "MagicSquare.h"
+#include "TestCheck.h"
+
+using MagicSquares::CanonicalForm;
+using MagicSquares::GridCell;
+using MagicSquares::RegulareSquare;
+
+namespace {
+
+	const size_t GRIDS_NUMBER = 4;      // by root size, half of them with void cells
+	const size_t VARIANTS_NUMBER = 24;  // by grid
+
+	// Values of a grid of N * N cells, the cell a, b at a * N + b
+	class GridValues
+	{
+	public:
+
+		GridValues(const GridCell* values, size_t root_size) :
+				mRootSize(root_size),
+				mSideSize(root_size * root_size),
+				mValues(values, values + root_size * root_size * root_size * root_size) {
+		};
+
+		const std::vector<GridCell>& values() const {
+			return mValues;
+		};
+
+		void relabel(std::mt19937& random_engine) {
+			std::vector<GridCell> labels(mSideSize + 1);
+			std::iota(labels.begin(), labels.end(), GridCell(0));
+			std::shuffle(labels.begin() + 1, labels.end(), random_engine);
+			for (GridCell& V : mValues) {
+				V = labels[V];
+			}
+		};
+
+		void transpose() {
+			for (size_t a = 0; a < mSideSize; a++) {
+				for (size_t b = a + 1; b < mSideSize; b++) {
+					std::swap(mValues[a * mSideSize + b], mValues[b * mSideSize + a]);
+				}
+			}
+		};
+
+		// Lines of the first index : a and b in the same band
+		void swapLines(size_t a, size_t b) {
+			std::swap_ranges(mValues.begin() + a * mSideSize, mValues.begin() + (a + 1) * mSideSize, mValues.begin() + b * mSideSize);
+		};
+
+		void swapBands(size_t a, size_t b) {
+			for (size_t k = 0; k < mRootSize; k++) {
+				this->swapLines(a * mRootSize + k, b * mRootSize + k);
+			}
+		};
+
+		// Through the transposition : columns and stacks are the lines and bands of the transposed grid
+		void swapColumns(size_t a, size_t b) {
+			this->transpose();
+			this->swapLines(a, b);
+			this->transpose();
+		};
+
+		void swapStacks(size_t a, size_t b) {
+			this->transpose();
+			this->swapBands(a, b);
+			this->transpose();
+		};
+
+		// A few random transformations of the whole group
+		void shuffle(std::mt19937& random_engine) {
+			for (size_t step = 0; step < 8; step++) {
+				const size_t band = random_engine() % mRootSize;
+				const size_t a = random_engine() % mRootSize;
+				const size_t b = random_engine() % mRootSize;
+				switch (random_engine() % 6) {
+				case 0:
+					this->relabel(random_engine);
+					break;
+				case 1:
+					this->transpose();
+					break;
+				case 2:
+					this->swapBands(a, b);
+					break;
+				case 3:
+					this->swapStacks(a, b);
+					break;
+				case 4:
+					this->swapLines(band * mRootSize + a, band * mRootSize + b);
+					break;
+				default:
+					this->swapColumns(band * mRootSize + a, band * mRootSize + b);
+					break;
+				}
+			}
+		};
+
+	private:
+
+		size_t                mRootSize;
+		size_t                mSideSize;
+		std::vector<GridCell> mValues;
+
+	};
+
+	// A solved grid, with about a third of its cells cleared if with_void_cells
+	std::vector<GridCell> randomGrid(size_t root_size, bool with_void_cells, std::mt19937& random_engine) {
+		RegulareSquare grid(root_size);
+		grid.setVerbose(false);
+		grid.setRandomSeed(random_engine());
+		TEST_CHECK(grid.generateSolvedGrid((root_size <= CanonicalForm::FULL_SEARCH_MAX_ROOT_SIZE) ?
+			RegulareSquare::FILL_RANDOMIZED_SEARCH : RegulareSquare::FILL_PATTERN_TRANSFORM) == RegulareSquare::ERR_OK);
+
+		std::vector<GridCell> values(grid.values(), grid.values() + root_size * root_size * root_size * root_size);
+		if (with_void_cells) {
+			for (GridCell& V : values) {
+				if (random_engine() % 3 == 0) {
+					V = 0;
+				}
+			}
+		}
+		return values;
+	}
+
+	void checkVariants(size_t root_size, std::mt19937& random_engine) {
+		const bool full_search = (root_size <= CanonicalForm::FULL_SEARCH_MAX_ROOT_SIZE);
+
+		for (size_t g = 0; g < GRIDS_NUMBER; g++) {
+			const std::vector<GridCell> values = randomGrid(root_size, (g % 2) == 1, random_engine);
+			const std::vector<GridCell> form = CanonicalForm::of(values.data(), root_size);
+
+			// The form is a grid of the class : its own form
+			TEST_CHECK(CanonicalForm::of(form.data(), root_size) == form);
+
+			// Same form through the grid
+			RegulareSquare grid(root_size);
+			grid.setVerbose(false);
+			TEST_CHECK(grid.fromValues(values.data()) == RegulareSquare::ERR_OK);
+			TEST_CHECK(CanonicalForm::hashOf(grid) == CanonicalForm::hash(form));
+
+			for (size_t v = 0; v < VARIANTS_NUMBER; v++) {
+				GridValues variant(values.data(), root_size);
+				if (full_search) {
+					variant.shuffle(random_engine);
+				} else {
+					variant.relabel(random_engine);
+					if (random_engine() % 2 == 0) {
+						variant.transpose();
+					}
+				}
+				TEST_CHECK(CanonicalForm::of(variant.values().data(), root_size) == form);
+			}
+		}
+	}
+
+}
+
+int main() {
+	std::mt19937 random_engine(20240615);
+
+	for (size_t root_size = RegulareSquare::MIN_GRID_ROOT_SIZE; root_size <= 5; root_size++) {
+		checkVariants(root_size, random_engine);
+	}
+
+	return MagicSquares::Tests::testResult("CanonicalFormTest");
+}
@@ -0,0 +1,188 @@
+// PuzzleBankWriter / PuzzleBank : puzzles written, then appended to the existing bank, read back by id with their
+// metadata, for several root sizes. A file which is not a bank (or a bank of another root size) is refused by both
+// and left as it was.
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PuzzleBank.h"
+#include "PuzzleBankWriter.h"
+#include "TestCheck.h"
+
+using MagicSquares::GridCell;
+using MagicSquares::PuzzleBank;
+using MagicSquares::PuzzleBankWriter;
+using MagicSquares::RegulareSquare;
+
+namespace {
+
+	const char* const BANK_PATH = "PuzzleBankTest.bank";
+	const char* const OTHER_PATH = "PuzzleBankTest.txt";
+
+	const size_t FIRST_PUZZLES_NUMBER = 12;
+	const size_t APPENDED_PUZZLES_NUMBER = 7;
+
+	typedef struct {
+		std::vector<GridCell>      Values;
+		PuzzleBank::PuzzleMetadata Metadata;
+	} WrittenPuzzle;
+
+	// A solved grid with cells cleared, and metadata using the whole width of their fields
+	WrittenPuzzle randomPuzzle(size_t root_size, std::mt19937& random_engine) {
+		RegulareSquare grid(root_size);
+		grid.setVerbose(false);
+		grid.setRandomSeed(random_engine());
+		TEST_CHECK(grid.generateSolvedGrid(RegulareSquare::FILL_PATTERN_TRANSFORM) == RegulareSquare::ERR_OK);
+
+		WrittenPuzzle puzzle;
+		puzzle.Values.assign(grid.values(), grid.values() + root_size * root_size * root_size * root_size);
+		size_t hints_number = puzzle.Values.size();
+		for (GridCell& V : puzzle.Values) {
+			if (random_engine() % 2 == 0) {
+				V = 0;
+				hints_number--;
+			}
+		}
+		puzzle.Metadata.HintsNumber = hints_number;
+		puzzle.Metadata.Level = static_cast<RegulareSquare::DIFFICULTY_LEVEL>(random_engine() % (RegulareSquare::DIFFICULTY_EXPERT + 1));
+		puzzle.Metadata.Score = random_engine();
+		puzzle.Metadata.SolutionsNumber = (random_engine() % 2 == 0) ? 1 : PuzzleBank::SOLUTIONS_UNKNOWN;
+		return puzzle;
+	}
+
+	std::vector<char> fileBytes(const char* path) {
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void appendPuzzles(size_t root_size, size_t puzzles_number, std::vector<WrittenPuzzle>& written, std::mt19937& random_engine) {
+		PuzzleBankWriter writer(BANK_PATH, root_size);
+		TEST_CHECK(writer.isOpen());
+		TEST_CHECK(writer.size() == written.size());
+		for (size_t p = 0; p < puzzles_number; p++) {
+			written.push_back(randomPuzzle(root_size, random_engine));
+			TEST_CHECK(writer.append(written.back().Values.data(), written.back().Metadata) == written.size() - 1);
+		}
+		TEST_CHECK(writer.size() == written.size());
+	}
+
+	// Every puzzle by id, in a random order
+	void checkBank(size_t root_size, const std::vector<WrittenPuzzle>& written, std::mt19937& random_engine) {
+		PuzzleBank bank(BANK_PATH);
+		TEST_CHECK(bank.isOpen());
+		if (!bank.isOpen()) {
+			return;
+		}
+		TEST_CHECK(bank.getRootSize() == root_size);
+		TEST_CHECK(bank.size() == written.size());
+
+		std::vector<size_t> ids(written.size());
+		for (size_t id = 0; id < ids.size(); id++) {
+			ids[id] = id;
+		}
+		std::shuffle(ids.begin(), ids.end(), random_engine);
+
+		std::vector<GridCell> values(root_size * root_size * root_size * root_size);
+		for (size_t id : ids) {
+			const WrittenPuzzle& puzzle = written[id];
+			bank.unpack(id, values.data());
+			TEST_CHECK(values == puzzle.Values);
+
+			const PuzzleBank::PuzzleMetadata metadata = bank.metadata(id);
+			TEST_CHECK(metadata.HintsNumber == puzzle.Metadata.HintsNumber);
+			TEST_CHECK(metadata.Level == puzzle.Metadata.Level);
+			TEST_CHECK(metadata.Score == puzzle.Metadata.Score);
+			TEST_CHECK(metadata.SolutionsNumber == puzzle.Metadata.SolutionsNumber);
+
+			RegulareSquare grid(root_size);
+			grid.setVerbose(false);
+			TEST_CHECK(bank.load(id, grid) == RegulareSquare::ERR_OK);
+			TEST_CHECK(std::vector<GridCell>(grid.values(), grid.values() + values.size()) == puzzle.Values);
+		}
+
+		RegulareSquare grid(root_size);
+		TEST_CHECK(bank.load(written.size(), grid) != RegulareSquare::ERR_OK);
+	}
+
+	void testRoundTrip(size_t root_size, std::mt19937& random_engine) {
+		std::remove(BANK_PATH);
+		std::vector<WrittenPuzzle> written;
+
+		appendPuzzles(root_size, FIRST_PUZZLES_NUMBER, written, random_engine);
+		checkBank(root_size, written, random_engine);
+
+		// The existing bank is completed, its puzzles kept
+		appendPuzzles(root_size, APPENDED_PUZZLES_NUMBER, written, random_engine);
+		checkBank(root_size, written, random_engine);
+
+		// An interrupted write : the partial record is not a puzzle, and the next append overwrites it
+		{
+			std::ofstream file(BANK_PATH, std::ios::out | std::ios::binary | std::ios::app);
+			file.write("\x01\x02\x03", 3);
+		}
+		checkBank(root_size, written, random_engine);
+		appendPuzzles(root_size, 1, written, random_engine);
+		checkBank(root_size, written, random_engine);
+		TEST_CHECK(fileBytes(BANK_PATH).size() == PuzzleBank::HEADER_SIZE + written.size() * PuzzleBank::recordSize(root_size));
+
+		// Another root size : refused, the bank is unchanged
+		const std::vector<char> bank_bytes = fileBytes(BANK_PATH);
+		{
+			PuzzleBankWriter writer(BANK_PATH, root_size + 1);
+			TEST_CHECK(!writer.isOpen());
+		}
+		TEST_CHECK(fileBytes(BANK_PATH) == bank_bytes);
+
+		std::remove(BANK_PATH);
+	}
+
+	void testOtherFile(const std::string& content) {
+		{
+			std::ofstream file(OTHER_PATH, std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write(content.data(), content.size());
+		}
+		const std::vector<char> bytes = fileBytes(OTHER_PATH);
+
+		{
+			PuzzleBank bank(OTHER_PATH);
+			TEST_CHECK(!bank.isOpen());
+			TEST_CHECK(bank.size() == 0);
+		}
+		{
+			PuzzleBankWriter writer(OTHER_PATH, 3);
+			TEST_CHECK(!writer.isOpen());
+		}
+		TEST_CHECK(fileBytes(OTHER_PATH) == bytes);
+
+		std::remove(OTHER_PATH);
+	}
+
+}
+
+int main() {
+	std::mt19937 random_engine(20240622);
+
+	for (size_t root_size = RegulareSquare::MIN_GRID_ROOT_SIZE; root_size <= 5; root_size++) {
+		testRoundTrip(root_size, random_engine);
+	}
+
+	// Text, shorter than a header, and a header of another format version
+	testOtherFile("530070000600195000098000060800060003400803001700020006060000280000419005000080079\n");
+	testOtherFile("MSQBANK");
+	std::string other_version(PuzzleBank::HEADER_SIZE, '\0');
+	PuzzleBank::writeHeader(reinterpret_cast<unsigned char*>(&other_version[0]), 3);
+	other_version[8] = static_cast<char>(PuzzleBank::FORMAT_VERSION + 1);
+	testOtherFile(other_version);
+
+	// Missing file : nothing to read
+	std::remove(OTHER_PATH);
+	PuzzleBank missing(OTHER_PATH);
+	TEST_CHECK(!missing.isOpen());
+
+	return MagicSquares::Tests::testResult("PuzzleBankTest");
+}
@@ -0,0 +1,233 @@
+// Search without grid copies : rewinding the undo trail must give back the exact state before the hypothesis
+// (values, candidates, rows / columns / blocks masks, filled cells count, hash), whatever the propagation did.
+// The solutions counts of the benchmark puzzles (MagicSquareBenchmark) are checked for every search setting.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MagicSquare.h"
+#include "TestCheck.h"
+
+namespace MagicSquares {
+
+	class SearchTrailTest
+	{
+	public:
+
+		// Random descents : a value is placed and propagated, then the trail is rewound at a random level
+		static void checkRewinds(const std::string& puzzle, unsigned int techniques, std::mt19937& random_engine) {
+			RegulareSquare grid(RegulareSquare::rootSizeOfLine(puzzle.size()));
+			grid.setVerbose(false);
+			TEST_CHECK(grid.fromLine(puzzle.data(), puzzle.size()) == RegulareSquare::ERR_OK);
+			grid.setPropagationTechniques(techniques);
+
+			const Snapshot initial(grid);
+			RegulareSquare::SearchTrail trail;
+
+			for (size_t descent = 0; descent < DESCENTS_NUMBER; descent++) {
+				std::vector<size_t>   marks;
+				std::vector<Snapshot> snapshots;
+
+				size_t i = 0;
+				size_t j = 0;
+				for (size_t placements = 0; (placements < MAX_PLACEMENTS) && randomCandidateCell(grid, random_engine, i, j); placements++) {
+					// One of the candidates of the cell
+					std::vector<size_t> values;
+					for (ValueMask remaining = grid.mAllowedValuesMap[i][j]; remaining != 0; remaining = clearLowestValue(remaining)) {
+						values.push_back(lowestValue(remaining));
+					}
+					const size_t V = values[random_engine() % values.size()];
+
+					marks.push_back(trail.size());
+					snapshots.push_back(Snapshot(grid));
+
+					grid.placeValue(i, j, V, &trail);
+					const bool consistent = grid.propagate(&trail);
+
+					// Back a few levels on a contradiction, sometimes on the way down (not too far : the descent goes on)
+					if (!consistent || (random_engine() % 4 == 0)) {
+						const size_t level = marks.size() - 1 - random_engine() % std::min<size_t>(marks.size(), MAX_REWOUND_LEVELS);
+						grid.rewindTrail(trail, marks[level]);
+						TEST_CHECK(snapshots[level] == Snapshot(grid));
+						marks.resize(level);
+						snapshots.erase(snapshots.begin() + level, snapshots.end());
+					}
+				}
+
+				// Solved, stuck without candidates or out of placements : every level is rewound in turn
+				while (!marks.empty()) {
+					grid.rewindTrail(trail, marks.back());
+					TEST_CHECK(snapshots.back() == Snapshot(grid));
+					marks.pop_back();
+					snapshots.pop_back();
+				}
+				TEST_CHECK(trail.empty());
+				TEST_CHECK(initial == Snapshot(grid));
+			}
+		}
+
+	private:
+
+		static const size_t DESCENTS_NUMBER = 20;
+		static const size_t MAX_REWOUND_LEVELS = 3;
+		static const size_t MAX_PLACEMENTS = 256;   // by descent : random choices may bounce on contradictions for long
+
+		// Search state of a grid
+		class Snapshot
+		{
+		public:
+
+			explicit Snapshot(const RegulareSquare& grid) :
+					mValues(grid.mInternalGrid),
+					mCandidates(grid.mAllowedValuesMap),
+					mRowsMask(grid.mRowsMask),
+					mColumnsMask(grid.mColumnsMask),
+					mBlocksMask(grid.mBlocksMask),
+					mFilledCellsCount(grid.mFilledCellsCount),
+					mGridHash(grid.mGridHash) {
+			};
+
+			bool operator==(const Snapshot& other) const {
+				return (mValues == other.mValues) && (mCandidates == other.mCandidates) &&
+					   (mRowsMask == other.mRowsMask) && (mColumnsMask == other.mColumnsMask) && (mBlocksMask == other.mBlocksMask) &&
+					   (mFilledCellsCount == other.mFilledCellsCount) && (mGridHash == other.mGridHash);
+			};
+
+		private:
+
+			RegulareSquare::InternalGrid   mValues;
+			RegulareSquare::CandidatesGrid mCandidates;
+			std::vector<ValueMask>         mRowsMask;
+			std::vector<ValueMask>         mColumnsMask;
+			std::vector<ValueMask>         mBlocksMask;
+			size_t                         mFilledCellsCount;
+			uint64_t                       mGridHash;
+
+		};
+
+		// A random void cell with candidates, false if there is none
+		static bool randomCandidateCell(const RegulareSquare& grid, std::mt19937& random_engine, size_t& i, size_t& j) {
+			std::vector<size_t> cells;
+			for (size_t k = 0; k < grid.mMaxAllowedValue * grid.mMaxAllowedValue; k++) {
+				if ((grid.mInternalGrid.data()[k] == RegulareSquare::VOID_VALUE) && (grid.mAllowedValuesMap.data()[k] != 0)) {
+					cells.push_back(k);
+				}
+			}
+			if (cells.empty()) {
+				return false;
+			}
+			const size_t k = cells[random_engine() % cells.size()];
+			i = k / grid.mMaxAllowedValue;
+			j = k % grid.mMaxAllowedValue;
+			return true;
+		}
+
+	};
+
+}
+
+namespace {
+
+	using MagicSquares::RegulareSquare;
+
+	typedef struct {
+		const char* Puzzle;
+		size_t      SolutionsNumber;   // counted by an independent brute force search
+	} CountedPuzzle;
+
+	// Same puzzles as MagicSquareBenchmark. The first "hard" one is the famous puzzle with a digit left out :
+	// it has several solutions, which makes it a good counting case too
+	const std::vector<CountedPuzzle>& countedPuzzles() {
+		static const std::vector<CountedPuzzle> puzzles = {
+			{ "530070000600195000098000060800060003400803001700020006060000280000419005000080079", 1 },
+			{ "003020600900305001001806400008102900700000008006708200002609500800203009005010300", 1 },
+			{ "200080300060070084030500209000105408000000000402706000301007040720040060004010003", 1 },
+			{ "800000000003600000070090000050007000000045700000100030001000068008500010090000400", 3219 },
+			{ "100007090030020008009600500005300900010080002600004000300000010040000007007000300", 1 },
+			{ "000000039000001005003050800008090006070002000100400000009080050020000600400700000", 1 },
+			{ "000000012000000003002300400001800005060070800000009000008500000900040500470006000", 1 },
+			{ "000000010400000000020000000000050407008000300001090000300400200050100000000806000", 1 },
+			{ "000000010400000000020000000000050604008000300001090000300400200050100000000807000", 1 },
+			{ "000000012000035000000600070700000300000400800100000000000120000080000040050000600", 1 },
+			{ "000000012003600000000007000410020000000500300700000600280000040000300500000000000", 1 },
+			{ "000000000000003085001020000000500000004000100090000000500000073002010000000040009", 5497 },
+			{ "....AC........FE......B586.....A....62..A7.E9G..B.8F..G35.....62G1...BFC..D.......36G.1...4.......D....4.8.G...3...B..8..A56F.D..8.GEA37....C.9..46C.....F...38.7B......2..4..GF.....5.F..7.1.2...B.3......D..7.EFA.....3.C.G.58D.7.C.4..G......8.13...69.2...B.", 1 },
+			{ ".241...E..7..6........8.....54.....B.F27..9A1....6G7.1....8.9.3.1..8..736...DF...CA..8...E.....6.....4.....8AE....6.....C.G4..5.6...7..CD...E1.GC..A.DE.3.F....B..F4....A..E.C.8D7..45...B..3....4....AB8.E1..F.78E3..G12A6..D.4.B.........7.....5...7..B3.9...A", 1 },
+			{ "1.4..7..2F.E5.6.....65.4D...287.7.8..13.C..5........F....3.1E.C.4.........6.31...B......8.1..D.C..6.82GC.......958.GA4E....D...F3....G..94F.C..D......1..2....B5.1...DF6...8...4B95...C..........2....476.EF1......E19.FB7D...4283...AB24......6.G.45...........", 1 }
+		};
+		return puzzles;
+	}
+
+	void loadPuzzle(RegulareSquare& grid, const std::string& puzzle, RegulareSquare::SOLVER_BACKEND backend,
+					RegulareSquare::SEARCH_STRATEGY strategy, unsigned int techniques) {
+		grid.setVerbose(false);
+		TEST_CHECK(grid.fromLine(puzzle.data(), puzzle.size()) == RegulareSquare::ERR_OK);
+		grid.setSolverBackend(backend);
+		grid.setSearchStrategy(strategy);
+		grid.setPropagationTechniques(techniques);
+	}
+
+	void checkSolutionsNumber(const CountedPuzzle& puzzle, RegulareSquare::SOLVER_BACKEND backend,
+							  RegulareSquare::SEARCH_STRATEGY strategy, unsigned int techniques) {
+		RegulareSquare grid(RegulareSquare::rootSizeOfLine(strlen(puzzle.Puzzle)));
+		loadPuzzle(grid, puzzle.Puzzle, backend, strategy, techniques);
+		TEST_CHECK(grid.countSolutions() == puzzle.SolutionsNumber);
+		TEST_CHECK(grid.hasUniqueSolution() == (puzzle.SolutionsNumber == 1));
+	}
+
+	// Same count with the solutions stored, and streamed
+	void checkSolutionsOutputs(const CountedPuzzle& puzzle) {
+		RegulareSquare grid(RegulareSquare::rootSizeOfLine(strlen(puzzle.Puzzle)));
+		loadPuzzle(grid, puzzle.Puzzle, RegulareSquare::SOLVER_BACKTRACKING, RegulareSquare::SEARCH_MRV,
+				   RegulareSquare::PROPAGATE_NAKED_SINGLES | RegulareSquare::PROPAGATE_HIDDEN_SINGLES);
+		grid.solve(false);
+		TEST_CHECK(grid.getSolutionsNumber() == puzzle.SolutionsNumber);
+
+		size_t visited = 0;
+		TEST_CHECK(grid.enumerateSolutions([&visited](const MagicSquares::GridCell*) {
+			visited++;
+			return true;
+		}) == puzzle.SolutionsNumber);
+		TEST_CHECK(visited == puzzle.SolutionsNumber);
+	}
+
+}
+
+int main() {
+	std::mt19937 random_engine(20240601);
+
+	const unsigned int techniques_settings[] = {
+		RegulareSquare::PROPAGATE_NONE,
+		RegulareSquare::PROPAGATE_NAKED_SINGLES | RegulareSquare::PROPAGATE_HIDDEN_SINGLES,
+		RegulareSquare::PROPAGATE_ALL
+	};
+
+	for (const CountedPuzzle& puzzle : countedPuzzles()) {
+		const bool big_grid = (strlen(puzzle.Puzzle) > 81);
+
+		for (unsigned int techniques : techniques_settings) {
+			MagicSquares::SearchTrailTest::checkRewinds(puzzle.Puzzle, techniques, random_engine);
+		}
+
+		// Exact cover search : independent of the hypothesis search
+		checkSolutionsNumber(puzzle, RegulareSquare::SOLVER_DANCING_LINKS, RegulareSquare::SEARCH_MRV, techniques_settings[1]);
+		checkSolutionsOutputs(puzzle);
+
+		// Without propagation, only the dynamic cell selection searches in a reasonable time (and not the 16 * 16 grids)
+		for (unsigned int techniques : techniques_settings) {
+			if (big_grid && (techniques == RegulareSquare::PROPAGATE_NONE)) {
+				continue;
+			}
+			checkSolutionsNumber(puzzle, RegulareSquare::SOLVER_BACKTRACKING, RegulareSquare::SEARCH_MRV, techniques);
+			checkSolutionsNumber(puzzle, RegulareSquare::SOLVER_BACKTRACKING, RegulareSquare::SEARCH_MRV_DEGREE, techniques);
+			if (!big_grid && (techniques != RegulareSquare::PROPAGATE_NONE)) {
+				checkSolutionsNumber(puzzle, RegulareSquare::SOLVER_BACKTRACKING, RegulareSquare::SEARCH_STATIC_ORDER, techniques);
+			}
+		}
+	}
+
+	return MagicSquares::Tests::testResult("SearchTrailTest");
+}
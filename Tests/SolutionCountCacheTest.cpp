@@ -0,0 +1,162 @@
+// SolutionCountCache : lookup, LRU eviction, backward shift deletion in a wrapped probe chain, reset by generation.
+// The hashes are chosen by their home slot : a cache of capacity C has the next power of two >= 2 * C slots,
+// the home slot of a hash is its low bits.
+
+#include <cstdint>
+
+#include "SolutionCountCache.h"
+#include "TestCheck.h"
+
+using MagicSquares::SolutionCountCache;
+
+namespace {
+
+	// Hash of home slot home (out of 8 slots), made unique by its high bits
+	uint64_t hashAt(size_t home, uint64_t tag) {
+		return (tag << 32) | home;
+	}
+
+	bool isCached(SolutionCountCache& cache, uint64_t hash, SolutionCountCache::SOLUTIONS_VERDICT expected) {
+		SolutionCountCache::SOLUTIONS_VERDICT verdict = (expected == SolutionCountCache::UNIQUE_SOLUTION) ?
+			SolutionCountCache::MULTIPLE_SOLUTIONS : SolutionCountCache::UNIQUE_SOLUTION;
+		return cache.find(hash, verdict) && (verdict == expected);
+	}
+
+	bool isMissing(SolutionCountCache& cache, uint64_t hash) {
+		SolutionCountCache::SOLUTIONS_VERDICT verdict = SolutionCountCache::UNIQUE_SOLUTION;
+		return !cache.find(hash, verdict);
+	}
+
+	void testInsertAndFind() {
+		SolutionCountCache cache;
+		cache.reset(16);
+		TEST_CHECK(cache.getCapacity() == 16);
+		TEST_CHECK(cache.size() == 0);
+		TEST_CHECK(isMissing(cache, 42));
+
+		for (uint64_t h = 1; h <= 10; h++) {
+			cache.insert(h * 0x9E3779B97F4A7C15ULL, (h % 2 == 0) ? SolutionCountCache::UNIQUE_SOLUTION : SolutionCountCache::MULTIPLE_SOLUTIONS);
+		}
+		TEST_CHECK(cache.size() == 10);
+		for (uint64_t h = 1; h <= 10; h++) {
+			TEST_CHECK(isCached(cache, h * 0x9E3779B97F4A7C15ULL, (h % 2 == 0) ? SolutionCountCache::UNIQUE_SOLUTION : SolutionCountCache::MULTIPLE_SOLUTIONS));
+		}
+		TEST_CHECK(isMissing(cache, 11 * 0x9E3779B97F4A7C15ULL));
+
+		// A known grid gets its new verdict, without a second entry
+		cache.insert(0x9E3779B97F4A7C15ULL, SolutionCountCache::UNIQUE_SOLUTION);
+		TEST_CHECK(cache.size() == 10);
+		TEST_CHECK(isCached(cache, 0x9E3779B97F4A7C15ULL, SolutionCountCache::UNIQUE_SOLUTION));
+
+		TEST_CHECK(cache.getHitsNumber() == 11);
+		TEST_CHECK(cache.getMissesNumber() == 2);
+
+		// Capacity 0 : nothing is remembered
+		cache.reset(0);
+		cache.insert(7, SolutionCountCache::UNIQUE_SOLUTION);
+		TEST_CHECK(cache.size() == 0);
+		TEST_CHECK(isMissing(cache, 7));
+	}
+
+	void testEvictionOrder() {
+		SolutionCountCache cache;
+		cache.reset(4);
+		for (uint64_t h = 1; h <= 4; h++) {
+			cache.insert(h, SolutionCountCache::UNIQUE_SOLUTION);
+		}
+
+		// 1 is used again : 2 becomes the least recently used, then 3
+		TEST_CHECK(isCached(cache, 1, SolutionCountCache::UNIQUE_SOLUTION));
+		cache.insert(5, SolutionCountCache::MULTIPLE_SOLUTIONS);
+		TEST_CHECK(cache.size() == 4);
+		TEST_CHECK(cache.getEvictionsNumber() == 1);
+		TEST_CHECK(isMissing(cache, 2));
+
+		// Updating a verdict counts as a use too : 3 is kept, 4 goes
+		cache.insert(3, SolutionCountCache::MULTIPLE_SOLUTIONS);
+		cache.insert(6, SolutionCountCache::UNIQUE_SOLUTION);
+		TEST_CHECK(isMissing(cache, 4));
+		TEST_CHECK(isCached(cache, 3, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, 1, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(isCached(cache, 5, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, 6, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(cache.getEvictionsNumber() == 2);
+	}
+
+	void testDeletionInWrappedChain() {
+		// Capacity 4 : 8 slots. a, b, d have their home in the last slot, c in the first one :
+		// a in slot 7, b wraps to slot 0, c is pushed to slot 1, d to slot 2
+		SolutionCountCache cache;
+		cache.reset(4);
+		const uint64_t a = hashAt(7, 1);
+		const uint64_t b = hashAt(7, 2);
+		const uint64_t c = hashAt(0, 3);
+		const uint64_t d = hashAt(7, 4);
+		cache.insert(a, SolutionCountCache::UNIQUE_SOLUTION);
+		cache.insert(b, SolutionCountCache::MULTIPLE_SOLUTIONS);
+		cache.insert(c, SolutionCountCache::UNIQUE_SOLUTION);
+		cache.insert(d, SolutionCountCache::MULTIPLE_SOLUTIONS);
+
+		// a (least recently used, head of the chain) is evicted : b, c and d are shifted back over the wrap around
+		const uint64_t e = hashAt(3, 5);
+		cache.insert(e, SolutionCountCache::UNIQUE_SOLUTION);
+		TEST_CHECK(cache.size() == 4);
+		TEST_CHECK(isMissing(cache, a));
+
+		// Still reachable from their home slot (found in the LRU order : the order is kept)
+		TEST_CHECK(isCached(cache, b, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, c, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(isCached(cache, d, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, e, SolutionCountCache::UNIQUE_SOLUTION));
+
+		// The LRU links follow the moved slots : b, then c, then d are evicted in order
+		const uint64_t f = hashAt(7, 6);
+		cache.insert(f, SolutionCountCache::MULTIPLE_SOLUTIONS);
+		TEST_CHECK(isMissing(cache, b));
+		TEST_CHECK(isCached(cache, c, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(isCached(cache, d, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, e, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(isCached(cache, f, SolutionCountCache::MULTIPLE_SOLUTIONS));
+
+		// Now c is the least recently used : evicted from the middle of the chain d, f (homes 7) and c (home 0)
+		const uint64_t g = hashAt(0, 7);
+		cache.insert(g, SolutionCountCache::UNIQUE_SOLUTION);
+		TEST_CHECK(isMissing(cache, c));
+		TEST_CHECK(isCached(cache, d, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, e, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(isCached(cache, f, SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isCached(cache, g, SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(cache.size() == 4);
+	}
+
+	void testStaleGeneration() {
+		SolutionCountCache cache;
+		cache.reset(4);
+		cache.insert(hashAt(1, 1), SolutionCountCache::UNIQUE_SOLUTION);
+		cache.insert(hashAt(1, 2), SolutionCountCache::MULTIPLE_SOLUTIONS);
+
+		// Same capacity : the table is kept, its slots are stale
+		cache.reset(4);
+		TEST_CHECK(cache.size() == 0);
+		TEST_CHECK(cache.getHitsNumber() == 0);
+		TEST_CHECK(isMissing(cache, hashAt(1, 1)));
+		TEST_CHECK(isMissing(cache, hashAt(1, 2)));
+
+		// A stale slot is free : the new grid takes the home slot, the chain starts again from it
+		cache.insert(hashAt(1, 2), SolutionCountCache::UNIQUE_SOLUTION);
+		cache.insert(hashAt(1, 3), SolutionCountCache::MULTIPLE_SOLUTIONS);
+		TEST_CHECK(isCached(cache, hashAt(1, 2), SolutionCountCache::UNIQUE_SOLUTION));
+		TEST_CHECK(isCached(cache, hashAt(1, 3), SolutionCountCache::MULTIPLE_SOLUTIONS));
+		TEST_CHECK(isMissing(cache, hashAt(1, 1)));
+		TEST_CHECK(cache.size() == 2);
+	}
+
+}
+
+int main() {
+	testInsertAndFind();
+	testEvictionOrder();
+	testDeletionInWrappedChain();
+	testStaleGeneration();
+	return MagicSquares::Tests::testResult("SolutionCountCacheTest");
+}
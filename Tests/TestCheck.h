@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+// Checks of the test programs : each failed check is reported on std::cerr, and testResult gives the exit code.
+// A test program is built with the library sources (every .cpp of the root but the mains), for instance :
+//
+//   g++ -std=c++14 -O2 -pthread -I.. SolutionCountCacheTest.cpp <library sources> -o SolutionCountCacheTest
+
+namespace MagicSquares {
+
+	namespace Tests {
+
+		inline size_t& failuresNumber() {
+			static size_t failures_number = 0;
+			return failures_number;
+		}
+
+		inline bool check(bool condition, const char* expression, const char* file, int line) {
+			if (!condition) {
+				std::cerr << file << ":" << line << ": check failed : " << expression << std::endl;
+				failuresNumber()++;
+			}
+			return condition;
+		}
+
+		inline int testResult(const char* test_name) {
+			if (failuresNumber() != 0) {
+				std::cerr << test_name << " : " << failuresNumber() << " failed checks" << std::endl;
+				return 1;
+			}
+			std::cout << test_name << " : OK" << std::endl;
+			return 0;
+		}
+
+	}
+
+}
+
+#define TEST_CHECK(condition) MagicSquares::Tests::check((condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace MagicSquares {
+
+	// Set of values stored as a bitmask : value V (1 to N) is bit V - 1
+	typedef uint64_t ValueMask;
+
+	// Number of values a ValueMask can hold (i.e. grid root size up to 8)
+	static const size_t MAX_MASK_VALUES = 64;
+
+	inline ValueMask valueBit(size_t V) {
+		return ValueMask(1) << (V - 1);
+	}
+
+	// Mask holding all the values from 1 to values_number
+	inline ValueMask fullMask(size_t values_number) {
+		return (values_number >= MAX_MASK_VALUES) ? ~ValueMask(0) : ((ValueMask(1) << values_number) - 1);
+	}
+
+	inline size_t countValues(ValueMask mask) {
+#if defined(_MSC_VER)
+		return static_cast<size_t>(__popcnt64(mask));
+#else
+		return static_cast<size_t>(__builtin_popcountll(mask));
+#endif
+	}
+
+	// Lowest value of a non empty mask
+	inline size_t lowestValue(ValueMask mask) {
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanForward64(&index, mask);
+		return static_cast<size_t>(index) + 1;
+#else
+		return static_cast<size_t>(__builtin_ctzll(mask)) + 1;
+#endif
+	}
+
+	inline ValueMask clearLowestValue(ValueMask mask) {
+		return mask & (mask - 1);
+	}
+
+	inline bool hasValue(ValueMask mask, size_t V) {
+		return (mask & valueBit(V)) != 0;
+	}
+
+}
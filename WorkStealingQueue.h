@@ -0,0 +1,50 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace MagicSquares {
+
+	// Double ended task queue of a worker : the owner pushes and pops the newest tasks (depth first),
+	// idle workers steal the oldest ones (closest to the root of the search tree, so the biggest).
+	template <typename T>
+	class WorkStealingQueue
+	{
+	public:
+
+		void push(T&& item) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			mItems.push_back(std::move(item));
+		};
+
+		// Owner side
+		bool pop(T& item) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mItems.empty()) {
+				return false;
+			}
+			item = std::move(mItems.back());
+			mItems.pop_back();
+			return true;
+		};
+
+		// Thief side
+		bool steal(T& item) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mItems.empty()) {
+				return false;
+			}
+			item = std::move(mItems.front());
+			mItems.pop_front();
+			return true;
+		};
+
+	private:
+
+		std::mutex    mMutex;
+		std::deque<T> mItems;
+
+	};
+
+}